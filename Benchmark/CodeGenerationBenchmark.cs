@@ -21,9 +21,9 @@ public sealed class CodeGenerationBenchmark
     }
 
     [Benchmark]
-    public string RunC()
+    public void RunC()
     {
         CodeGenerator.TryGet(Language.CliOption.C, out var cg);
-        return cg.NotNull()(p.Msger, _sast.NotNull());
+        cg.NotNull()(p.Msger, _sast.NotNull(), TextWriter.Null);
     }
 }
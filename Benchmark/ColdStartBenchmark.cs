@@ -0,0 +1,32 @@
+using System.Diagnostics;
+
+using BenchmarkDotNet.Attributes;
+using BenchmarkDotNet.Engines;
+
+using Scover.Psdc.Library;
+
+namespace Scover.Psdc.Benchmark;
+
+/// <summary>
+/// Measures the end-to-end latency of a fresh <c>psdc</c> process, including startup and static initialization.
+/// </summary>
+/// <remarks>Point this to a published (Native AOT) binary to measure what users actually run.</remarks>
+[SimpleJob(RunStrategy.ColdStart, launchCount: 1, warmupCount: 0, iterationCount: 30)]
+public class ColdStartBenchmark
+{
+    static readonly Parameters p = Program.Parameters;
+
+    [Benchmark]
+    public int Run()
+    {
+        using var process = Process.Start(new ProcessStartInfo(p.Executable, ["c", p.Filename, "-o", "-"]) {
+            RedirectStandardOutput = true,
+            RedirectStandardError = true,
+        }).NotNull();
+        // Drain standard error concurrently, so the child can't block on a full pipe while standard output is read.
+        process.BeginErrorReadLine();
+        process.StandardOutput.ReadToEnd();
+        process.WaitForExit();
+        return process.ExitCode;
+    }
+}
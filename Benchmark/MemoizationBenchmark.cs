@@ -0,0 +1,23 @@
+﻿using BenchmarkDotNet.Attributes;
+
+using Scover.Psdc.Parsing;
+using Scover.Psdc.Lexing;
+
+namespace Scover.Psdc.Benchmark;
+
+[MemoryDiagnoser]
+public sealed class MemoizationBenchmark
+{
+    static readonly Parameters p = Program.Parameters;
+    Token[] _tokens = null!;
+
+    [Params(false, true)]
+    public bool Memoize { get; set; }
+
+    [GlobalSetup]
+    public void Setup() => _tokens = new LexingBenchmark().Run();
+
+    [Benchmark]
+    public ValueOption<Node.Algorithm> Run()
+        => Parser.Parse(p.Msger, _tokens, Memoize);
+}
@@ -0,0 +1,71 @@
+using System.Text;
+
+using BenchmarkDotNet.Attributes;
+
+using Scover.Psdc.CodeGeneration;
+using Scover.Psdc.Lexing;
+using Scover.Psdc.Parsing;
+using Scover.Psdc.StaticAnalysis;
+
+namespace Scover.Psdc.Benchmark;
+
+[MemoryDiagnoser]
+public sealed class NestingBenchmark
+{
+    public enum NestingShape
+    {
+        ElseIfChain,
+        UnaryChain,
+        BinaryChain,
+        NestedParentheses,
+    }
+
+    string _input = null!;
+    Token[] _tokens = null!;
+    NameTable _names = null!;
+
+    [Params(1_000, 10_000, 100_000)]
+    public int Depth { get; set; }
+
+    [Params(NestingShape.ElseIfChain, NestingShape.UnaryChain, NestingShape.BinaryChain, NestingShape.NestedParentheses)]
+    public NestingShape Shape { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        StringBuilder input = new("programme nesting c'est\ndébut\n    x : entier;\n");
+        switch (Shape) {
+        case NestingShape.ElseIfChain:
+            input.Append("    si x == 0 alors x := 0;\n");
+            for (int i = 1; i < Depth; ++i) {
+                input.Append($"    sinonsi x == {i} alors x := {i};\n");
+            }
+            input.Append("    finsi\n");
+            break;
+        case NestingShape.UnaryChain:
+            input.Append("    x := ").Insert(input.Length, "- ", Depth).Append("1;\n");
+            break;
+        case NestingShape.BinaryChain:
+            input.Append("    x := 1").Insert(input.Length, " + 1", Depth).Append(";\n");
+            break;
+        case NestingShape.NestedParentheses:
+            // Each level is the right operand of the enclosing one, so the parentheses don't collapse.
+            input.Append("    x := 1").Insert(input.Length, " + (1", Depth).Insert(input.Length, ")", Depth).Append(";\n");
+            break;
+        }
+        input.Append("fin");
+        _input = input.ToString();
+        _names = new();
+        _tokens = Lexer.Lex(IgnoreMessenger.Instance, _input, _names).ToArray();
+    }
+
+    // Every shape must compile within the default nesting limit, with the default options of the command line.
+    [Benchmark]
+    public void Run()
+    {
+        var ast = Parser.Parse(IgnoreMessenger.Instance, _tokens).Unwrap();
+        var sast = StaticAnalyzer.Analyze(IgnoreMessenger.Instance, _input, _names, ast);
+        CodeGenerator.TryGet(Language.CliOption.C, out var cg);
+        cg.NotNull()(IgnoreMessenger.Instance, sast, TextWriter.Null);
+    }
+}
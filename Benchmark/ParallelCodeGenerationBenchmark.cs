@@ -0,0 +1,70 @@
+using System.Text;
+
+using BenchmarkDotNet.Attributes;
+
+using Scover.Psdc.CodeGeneration;
+using Scover.Psdc.Lexing;
+using Scover.Psdc.Library;
+using Scover.Psdc.Parsing;
+using Scover.Psdc.StaticAnalysis;
+
+namespace Scover.Psdc.Benchmark;
+
+[MemoryDiagnoser]
+public sealed class ParallelCodeGenerationBenchmark
+{
+    SemanticNode.Algorithm _sast = null!;
+
+    [Params(100, 1_000)]
+    public int Callables { get; set; }
+
+    [ParamsSource(nameof(DegreesOfParallelism))]
+    public int DegreeOfParallelism { get; set; }
+
+    // Powers of 2 up to the core count, then the core count.
+    public static IEnumerable<int> DegreesOfParallelism()
+    {
+        int degree = 1;
+        for (; degree < Environment.ProcessorCount; degree *= 2) {
+            yield return degree;
+        }
+        yield return Environment.ProcessorCount;
+    }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        StringBuilder input = new("programme parallel c'est\n");
+        input.Append("type point = structure début x, y : entier; fin;\n");
+        for (int i = 0; i < Callables; ++i) {
+            input.Append($"""
+                fonction f{i}(entF n : entier, entF/sortF p : point) délivre entier c'est début
+                    t : tableau[10] de point;
+                    i : entier;
+                    pour i de 1 à 10 faire
+                        t[i].x := n * i + (n - 1) / 2;
+                        t[i].y := t[i].x % 3;
+                        si t[i].x > p.x et n < 5 alors
+                            écrireEcran("x = ", t[i].x);
+                        finsi
+                    finfaire
+                    retourne t[1].x + p.y;
+                fin
+
+                """);
+        }
+        input.Append("début\nfin");
+
+        var m = IgnoreMessenger.Instance;
+        var source = input.ToString();
+        NameTable names = new();
+        _sast = StaticAnalyzer.Analyze(m, source, names, Parser.Parse(m, Lexer.Lex(m, source, names).ToArray()).Unwrap());
+    }
+
+    [Benchmark]
+    public void Run()
+    {
+        CodeGenerator.TryGet(Language.CliOption.C, out var cg, DegreeOfParallelism);
+        cg.NotNull()(IgnoreMessenger.Instance, _sast, TextWriter.Null);
+    }
+}
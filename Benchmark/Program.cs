@@ -9,31 +9,37 @@ static class Program
 {
     static void Main(string[] args)
     {
-        if (args.Length != 1) {
-            Console.Error.WriteLine($"usage: {Path.GetRelativePath(Environment.CurrentDirectory, Environment.ProcessPath ?? "benchmark")} INPUT_FILE");
+        if (args.Length is not (1 or 2)) {
+            Console.Error.WriteLine($"usage: {Path.GetRelativePath(Environment.CurrentDirectory, Environment.ProcessPath ?? "benchmark")} INPUT_FILE [PSDC_EXECUTABLE]");
             return;
         }
         var filename = Path.GetFullPath(args[0]);
         Console.WriteLine($"Benchmarking {filename}");
 
         Environment.SetEnvironmentVariable(EnvNameFilename, filename);
+        if (args.Length == 2) {
+            Environment.SetEnvironmentVariable(EnvNameExecutable, Path.GetFullPath(args[1]));
+        }
 
-        BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run(args[1..],
+        BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run([],
             ManualConfig.Create(DefaultConfig.Instance)
                .WithOptions(ConfigOptions.JoinSummary));
     }
 
     const string EnvNameFilename = "psdc_benchmark_filename";
+    const string EnvNameExecutable = "psdc_benchmark_executable";
 
     public static Parameters Parameters {
         get {
             var filename = Environment.GetEnvironmentVariable(EnvNameFilename)
                         ?? throw new InvalidOperationException("Filename env var not set");
             var input = File.ReadAllText(filename);
+            // Defaults to the psdc found in PATH
+            var executable = Environment.GetEnvironmentVariable(EnvNameExecutable) ?? "psdc";
 
-            return new(input, IgnoreMessenger.Instance);
+            return new(input, IgnoreMessenger.Instance, filename, executable);
         }
     }
 }
 
-readonly record struct Parameters(string Input, Messenger Msger);
+readonly record struct Parameters(string Input, Messenger Msger, string Filename, string Executable);
@@ -1,5 +1,6 @@
 ﻿using BenchmarkDotNet.Attributes;
 
+using Scover.Psdc.Lexing;
 using Scover.Psdc.Parsing;
 using Scover.Psdc.StaticAnalysis;
 
@@ -9,17 +10,13 @@ namespace Scover.Psdc.Benchmark;
 public sealed class StaticAnalysisBenchmark
 {
     static readonly Parameters p = Program.Parameters;
+    readonly NameTable _names = new();
     Node.Algorithm _ast = null!;
 
     [GlobalSetup]
-    public void Setup()
-    {
-        ParsingBenchmark b = new();
-        b.Setup();
-        _ast = b.Run().Unwrap();
-    }
+    public void Setup() => _ast = Parser.Parse(p.Msger, Lexer.Lex(p.Msger, p.Input, _names).ToArray()).Unwrap();
 
     [Benchmark]
     public SemanticNode.Algorithm Run()
-        => StaticAnalyzer.Analyze(p.Msger, p.Input, _ast);
+        => StaticAnalyzer.Analyze(p.Msger, p.Input, _names, _ast);
 }
@@ -8,10 +8,16 @@ sealed class CliOptions(
     string output,
     bool verbose,
     bool pedantic,
-    MessageStyle msgStyle
+    MessageStyle msgStyle,
+    int maxNestingDepth,
+    bool constObjects,
+    int maxCopySize,
+    int maxDegreeOfParallelism
 )
 {
     public const string StdStreamPlaceholder = "-";
+    /// <summary>The greatest value of <see cref="MaxNestingDepth"/>, whose stack still fits in the largest one the compilation runs on.</summary>
+    public const int MaxMaxNestingDepth = (Program.MaxStackSize - Program.BaseStackSize) / Program.StackSizePerNestingLevel;
     [Value(0, Required = true,
         HelpText = "Target language to compile to. More coming soon.",
         MetaValue = $"{Language.CliOption.C}")]
@@ -32,4 +38,27 @@ sealed class CliOptions(
         HelpText = "Style of the message list",
         MetaValue = "vscode/gnu/json")]
     public MessageStyle MsgStyle => msgStyle;
+    [Option("max-nesting", Default = Parsing.Parser.DefaultMaxNestingDepth,
+        HelpText = "Maximum nesting depth of expressions, statements, types and initializers. Blocks, braced initializers, parenthesized lvalues and the expressions in calls and subscripts are levels of nesting; parentheses and operators in expressions are not.")]
+    public int MaxNestingDepth => maxNestingDepth;
+    [Option("const-objects",
+        HelpText = "Generate braced constants as static const objects and integer constants as enumeration constants, rather than as macros. Braced constants are then not rebuilt at each use.")]
+    public bool ConstObjects => constObjects;
+    [Option("max-copy-size", Default = CodeGeneration.C.ParameterPassing.DefaultMaxCopySize,
+        HelpText = "Size in bytes above which input structure parameters are passed by const pointer rather than copied, when the callable doesn't modify them. Negative to always copy them.",
+        MetaValue = "bytes")]
+    public int MaxCopySize => maxCopySize;
+    [Option("max-parallelism", Default = -1,
+        HelpText = "Maximum number of callable definitions to generate concurrently. -1 for no limit, 1 to generate them in sequence. The generated code doesn't depend on it.",
+        MetaValue = "count")]
+    public int MaxDegreeOfParallelism => maxDegreeOfParallelism;
+
+    /// <summary>Gets the error in the option values that the command line parser can't check.</summary>
+    /// <returns>The error message, or <see langword="null"/> if the options are valid.</returns>
+    public string? Validate()
+        => MaxNestingDepth is < 1 or > MaxMaxNestingDepth
+            ? $"max nesting depth must be between 1 and {MaxMaxNestingDepth}, got {MaxNestingDepth}"
+            : MaxDegreeOfParallelism is 0 or < -1
+            ? $"max parallelism must be -1 or positive, got {MaxDegreeOfParallelism}"
+            : null;
 }
@@ -1,3 +1,4 @@
+using System.Runtime.CompilerServices;
 using System.Text;
 
 using Scover.Psdc.Pseudocode;
@@ -8,36 +9,191 @@ using static Scover.Psdc.StaticAnalysis.SemanticNode;
 
 namespace Scover.Psdc.CodeGeneration.C;
 
-sealed partial class CodeGenerator(Messenger messenger)
-    : CodeGenerator<KeywordTable, OperatorTable>(messenger, KeywordTable.Instance, OperatorTable.Instance)
+sealed partial class CodeGenerator(Messenger messenger, int maxDegreeOfParallelism, bool constantObjects, ParameterPassing parameterPassing)
+    : CodeGenerator<KeywordTable, OperatorTable>(messenger, KeywordTable.Instance, new(parameterPassing))
 {
     readonly IncludeSet _includes = new();
+    // The type info of each type, created on first use. The declarators of a type are only generated once.
+    readonly Dictionary<EvaluatedType, TypeInfo> _typeInfos = new(ReferenceEqualityComparer.Instance);
+    // The type infos that renamed a reserved keyword, which depend on the scope they were created in.
+    readonly Dictionary<TypeInfoKey, TypeInfo> _scopedTypeInfos = [];
+    readonly RenameTracker _typeInfoRenames = new(KeywordTable.Instance);
+    Generator<Expr>? _genExpr, _genExprAdd1;
+    // The operations whose operands are being generated, with whether they are bracketed and whether their second operand has been written. Shared by nested calls to AppendExpression, each above the previous ones.
+    readonly Stack<(Expr Operation, bool Bracket, bool SecondOperandWritten)> _openOperations = new();
+    // The operands left to check by IsConstantExpression.
+    readonly Stack<Expr> _constantOperands = new();
     Group _currentGroup = Group.None;
+    // Whether this generator generates a callable definition concurrently with others, on a thread whose stack may be smaller.
+    bool _speculative;
+    // How each constant is generated, when constants are generated as objects. Shared with the generators of callable definitions, which only read it.
+    Dictionary<Symbol.Constant, (ConstantForm Form, Initializer Value)> _constantForms = new(ReferenceEqualityComparer.Instance);
 
-    public override string Generate(Algorithm algorithm)
+    public override void Generate(Algorithm algorithm, TextWriter output)
     {
+        // The headers to include are only known once the body is generated, so the body is buffered, then written after the include section.
         StringBuilder o = new();
 
-        foreach (var decl in algorithm.Declarations) {
-            AppendDeclaration(o, decl);
+        parameterPassing.Choose(algorithm);
+        if (constantObjects) {
+            ChooseConstantForms(algorithm);
         }
+        var definitions = GenerateCallableDefinitions(algorithm);
+        for (int i = 0; i < algorithm.Declarations.Count; ++i) {
+            if (definitions[i] is { } def) {
+                Merge(def.Generator);
+                o.Append(def.Code);
+                // Release the definition once merged, so that its code isn't held twice until the end.
+                definitions[i] = null;
+            } else {
+                AppendDeclaration(o, algorithm.Declarations[i]);
+            }
+        }
+
+        WriteFileHeader(output, algorithm);
+        _includes.WriteIncludeSection(output);
+        output.Write(o);
+    }
+
+    readonly record struct GeneratedDefinition(CodeGenerator Generator, StringBuilder Code);
+
+    // Callable definitions only read the semantic AST, so they are generated concurrently, each by its own generator, then merged in source order.
+    // A definition whose generation reports messages is left to be generated in sequence, since its messages and the names it chooses may depend on the declarations before it.
+    GeneratedDefinition?[] GenerateCallableDefinitions(Algorithm algorithm)
+    {
+        var definitions = new GeneratedDefinition?[algorithm.Declarations.Count];
+        if (maxDegreeOfParallelism == 1) {
+            return definitions;
+        }
+        Parallel.For(0, definitions.Length, new() { MaxDegreeOfParallelism = maxDegreeOfParallelism }, i => {
+            if (algorithm.Declarations[i] is not Declaration.CallableDefinition def) {
+                return;
+            }
+            FilterMessenger msger = new(_ => true);
+            CodeGenerator generator = new(msger, 1, constantObjects, parameterPassing) {
+                _speculative = true,
+                _constantForms = _constantForms,
+            };
+            StringBuilder o = new();
+            try {
+                generator.AppendCallableDefinition(o, def);
+            } catch (InsufficientExecutionStackException) {
+                return;
+            }
+            if (!msger.Messages.Any()) {
+                definitions[i] = new(generator, o);
+            }
+        });
+        return definitions;
+    }
 
-        return _includes.AppendIncludeSection(AppendFileHeader(new(), algorithm))
-           .Append(o).ToString();
+    // Merges the state of a generator that generated a callable definition without reporting messages, as if the definition had been generated by this generator.
+    void Merge(CodeGenerator generator)
+    {
+        MergeSymbolNames(generator);
+        foreach (var (key, info) in generator._typeInfos) {
+            _typeInfos.TryAdd(key, info);
+        }
+        _includes.UnionWith(generator._includes);
+    }
+
+    enum ConstantForm
+    {
+        // An enumeration constant. Its value is an integer constant expression, so it can be used as an array length or a case label.
+        Enumeration,
+        // A static const object, so that braced constants aren't rebuilt at each use.
+        Object,
+        // A macro whose value is a constant expression. Other macros aren't in the forms.
+        ConstantMacro,
     }
 
+    // Chooses, in source order, the constants that can be generated as enumeration constants or static const objects.
+    // Other constants stay macros, since their value isn't a constant expression in C, or rebuilding it at each use costs nothing.
+    void ChooseConstantForms(Algorithm algorithm)
+    {
+        foreach (var constant in algorithm.Declarations.OfType<Declaration.Constant>()) {
+            switch (constant.Value) {
+            // A constant whose arrays are passed to callables stays a macro, since the callables take pointers that aren't const.
+            case Initializer.Braced braced when constant.Type is ArrayType or StructureType && IsConstantInitializer(braced)
+                                             && !parameterPassing.IsPassedAsWritable(constant.Symbol):
+                _constantForms.Add(constant.Symbol, (ConstantForm.Object, braced));
+                break;
+            case Expr expr when IsIntegerType(constant.Type) && IsConstantExpression(expr, true):
+                _constantForms.Add(constant.Symbol, (ConstantForm.Enumeration, expr));
+                break;
+            case Expr expr when IsConstantExpression(expr, false):
+                _constantForms.Add(constant.Symbol, (ConstantForm.ConstantMacro, expr));
+                break;
+            }
+        }
+
+        bool IsConstantInitializer(Initializer initializer) => initializer switch {
+            Initializer.Braced braced => braced.Items.All(i => IsConstantInitializer(i.Value)),
+            Expr expr => IsConstantExpression(expr, false),
+            _ => throw initializer.ToUnmatchedException(),
+        };
+    }
+
+    // Whether an expression is a constant expression in C, or an integer constant expression.
+    // Objects can't be read in constant expressions, and integer constant expressions can only refer to enumeration constants.
+    // Operands are walked with an explicit stack, so that deep expressions don't recurse.
+    bool IsConstantExpression(Expr expr, bool integer)
+    {
+        var operands = _constantOperands;
+        int start = operands.Count;
+        operands.Push(expr);
+        while (operands.Count != start) {
+            switch (operands.Pop()) {
+            case ParenExpr p:
+                operands.Push(p.ContainedExpression);
+                break;
+            case Expr.Literal l when !integer || IsIntegerType(l.Value.Type):
+                break;
+            case Expr.UnaryOperation { Operator: not UnaryOperator.Cast } opUn:
+                operands.Push(opUn.Operand);
+                break;
+            case Expr.BinaryOperation opBin when !IsStringComparison(opBin):
+                operands.Push(opBin.Right);
+                operands.Push(opBin.Left);
+                break;
+            case Expr.Lvalue.VariableReference { Symbol: { HasValue: true, Value: Symbol.Constant constant } }
+                when _constantForms.TryGetValue(constant, out var c)
+                  && (c.Form is ConstantForm.Enumeration || !integer && c.Form is ConstantForm.ConstantMacro):
+                break;
+            default:
+                while (operands.Count != start) {
+                    operands.Pop();
+                }
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool IsIntegerType(EvaluatedType type) => type is IntegerType or CharacterType or BooleanType;
+
     #region Declarations
 
     protected override StringBuilder AppendAliasDeclaration(StringBuilder o, Declaration.TypeAlias alias)
     {
         SetGroup(o, Group.Types);
         return Indent(o).AppendLine(Format.Code,
-            $"typedef {CreateTypeInfo(alias.Meta.Scope, alias.Type).GenerateDeclaration(ValidateIdentifier(alias.Meta.Scope, alias.Name))};");
+            $"typedef {CreateTypeInfo(alias.Meta.Scope, alias.Type).GenerateDeclaration(ValidateIdentifier(alias.Meta.Scope, alias.Symbol))};");
     }
 
     protected override StringBuilder AppendConstant(StringBuilder o, Declaration.Constant constant)
     {
-        var normalName = ValidateIdentifier(constant.Meta.Scope, constant.Name);
+        var normalName = ValidateIdentifier(constant.Meta.Scope, constant.Symbol);
+        if (_constantForms.TryGetValue(constant.Symbol, out var c) && c.Form is not ConstantForm.ConstantMacro) {
+            SetGroup(o, Group.Constants);
+            Indent(o);
+            return (c.Form switch {
+                ConstantForm.Enumeration => AppendExpression(o.Append(Format.Code, $"enum {{ {normalName} = "), (Expr)constant.Value).Append(" }"),
+                ConstantForm.Object => AppendBracedInitializer(o.Append(Format.Code,
+                    $"static {CreateTypeInfo(constant.Meta.Scope, constant.Type).ToConst().GenerateDeclaration(normalName)} = "), (Initializer.Braced)constant.Value),
+                _ => throw c.Form.ToUnmatchedException(),
+            }).AppendLine(";");
+        }
         return AppendCDefine(o, normalName, constant.Value switch {
             Initializer.Braced braced => AppendBracedInitializer(new(), braced),
             Expr expr => AppendExpression(new(), expr, OpTable.ShouldBracketOperand(OperatorInfo.None, expr)),
@@ -53,11 +209,11 @@ sealed partial class CodeGenerator(Messenger messenger)
     }
 
     protected override StringBuilder AppendCallableDeclaration(StringBuilder o, Declaration.Callable callable)
-        => AppendCallableSignature(SetGroup(o, Group.Prototypes), callable.Signature).AppendLine(";");
+        => AppendCallableSignature(SetGroup(o, Group.Prototypes), callable.Symbol, callable.Signature).AppendLine(";");
 
     protected override StringBuilder AppendCallableDefinition(StringBuilder o, Declaration.CallableDefinition def)
     {
-        AppendCallableSignature(o.AppendLine(), def.Signature);
+        AppendCallableSignature(o.AppendLine(), def.Symbol, def.Signature);
         return AppendBlock(o.Append(' '), def.Block).AppendLine();
     }
 
@@ -70,11 +226,11 @@ sealed partial class CodeGenerator(Messenger messenger)
            .AppendLine();
     }
 
-    StringBuilder AppendCallableSignature(StringBuilder o, CallableSignature sig)
+    StringBuilder AppendCallableSignature(StringBuilder o, Symbol.Callable callable, CallableSignature sig)
     {
-        o.Append(Format.Code, $"{CreateTypeInfo(sig.Meta.Scope, sig.ReturnType)} {ValidateIdentifier(sig.Meta.Scope, sig.Name)}(");
+        o.Append(Format.Code, $"{CreateTypeInfo(sig.Meta.Scope, sig.ReturnType)} {ValidateIdentifier(sig.Meta.Scope, callable)}(");
         if (sig.Parameters.Count != 0) {
-            o.AppendJoin(", ", sig.Parameters.Select(GenerateParameter));
+            o.AppendJoin(", ", sig.Parameters.Zip(callable.Parameters, GenerateParameter));
         } else {
             o.Append("void");
         }
@@ -83,15 +239,17 @@ sealed partial class CodeGenerator(Messenger messenger)
         return o;
     }
 
-    string GenerateParameter(ParameterFormal param)
+    string GenerateParameter(ParameterFormal param, Symbol.Parameter symbol)
     {
         StringBuilder o = new();
         var type = CreateTypeInfo(param.Meta.Scope, param.Type);
-        if (C.RequiresPointer(param.Mode, param.Type)) {
+        if (parameterPassing.IsByConstPointer(symbol)) {
+            type = type.ToPointer(1).ToConst();
+        } else if (C.RequiresPointer(param.Mode, param.Type)) {
             type = type.ToPointer(1);
         }
 
-        o.Append(type.GenerateDeclaration(ValidateIdentifier(param.Meta.Scope, param.Name)));
+        o.Append(type.GenerateDeclaration(ValidateIdentifier(param.Meta.Scope, symbol)));
 
         return o.ToString();
     }
@@ -143,7 +301,7 @@ sealed partial class CodeGenerator(Messenger messenger)
             _includes.Ensure(IncludeSet.String);
             AppendExpression(o.Append("memcpy("), assignment.Target);
             AppendExpression(o.Append(", "), assignment.Value);
-            AppendUnaryOperation(o.Append(", "), OpTable.SizeOf, assignment.Target, AppendExpression).Append(')');
+            AppendUnaryOperation(o.Append(", "), OpTable.SizeOf, assignment.Target).Append(')');
             break;
         default:
             AppendExpression(o, assignment.Target);
@@ -157,6 +315,7 @@ sealed partial class CodeGenerator(Messenger messenger)
 
     StringBuilder AppendBlock(StringBuilder o, SemanticBlock block, Action<StringBuilder>? suffix = null)
     {
+        EnsureSufficientStack();
         o.AppendLine("{");
         Indentation.Increase();
         AppendStatements(o, block);
@@ -272,7 +431,7 @@ sealed partial class CodeGenerator(Messenger messenger)
     protected override StringBuilder AppendLocalVariable(StringBuilder o, Statement.LocalVariable local)
     {
         Indent(o).Append(CreateTypeInfo(local.Meta.Scope, local.Decl.Type)
-           .GenerateDeclaration(local.Decl.Names.Select(n => ValidateIdentifier(local.Meta.Scope, n))));
+           .GenerateDeclaration(local.Decl.Symbols.Select(v => ValidateIdentifier(local.Meta.Scope, v))));
         local.Value.Tap(i => AppendInitializer(o.Append(" = "), i, false));
         return o.AppendLine(";");
     }
@@ -320,13 +479,6 @@ sealed partial class CodeGenerator(Messenger messenger)
 
     #region Expressions
 
-    StringBuilder AppendArraySubscript(StringBuilder o, Expr.Lvalue.ArraySubscript arrSub)
-    {
-        AppendExpression(o, arrSub.Array, OpTable.ShouldBracket(arrSub));
-        AppendIndex(o, arrSub.Index);
-        return o;
-    }
-
     StringBuilder AppendIndex(StringBuilder o, Expr index)
         => AppendExpressionAlter(o.Append('['), index, OpTable.Subtract, 1, (l, r) => l - r).Append(']');
 
@@ -338,6 +490,8 @@ sealed partial class CodeGenerator(Messenger messenger)
 
     StringBuilder AppendExpression(StringBuilder o, Expr expr) => AppendExpression(o, expr, false);
 
+    // Parentheses and operations nest their operands, so an expression is as deep as the source.
+    // Operands are walked in a loop, with the operations left to close on a stack, so that deep expressions don't recurse.
     StringBuilder AppendExpression(
         StringBuilder o,
         Expr expr,
@@ -346,64 +500,179 @@ sealed partial class CodeGenerator(Messenger messenger)
         bool bracket = false,
         bool convertInitToCompoundLiteral = true
     )
-        => AppendBetweenParens(o, bracket, o => {
+    {
+        EnsureSufficientStack();
+        int start = _openOperations.Count;
+        while (true) {
+            while (true) {
+                if (bracket) {
+                    o.Append('(');
+                }
+                if (OpenOperation(o, expr, bracket, out bool bracketOperand) is not { } operand) {
+                    break;
+                }
+                _openOperations.Push((expr, bracket, false));
+                (expr, bracket) = (operand, bracketOperand);
+            }
+
             _ = expr switch {
-                ParenExpr b => AppendExpression(o, b.ContainedExpression, !bracket),
                 Expr.Call call => AppendCall(o, call),
-                Expr.Literal(_, bool v, BooleanValue) => AppendLiteralBoolean(v),
+                Expr.Literal(_, bool v, BooleanValue) => AppendLiteralBoolean(o, v),
                 // We're using the Pseudocode syntax for escaping string literals since it is the same as C's (except for \? which we can ignore, no one uses trigraphs)
                 Expr.Literal { Value: CharacterValue v } => o.Append(v.ToString(Value.FmtNoType, Format.Code)),
                 Expr.Literal { Value: StringValue v } => o.Append(v.ToString(Value.FmtNoType, Format.Code)),
                 Expr.Literal l => o.Append(l.UnderlyingValue.ToStringFmt(Format.Code)),
-                Expr.Lvalue.ArraySubscript arrSub => AppendArraySubscript(o, arrSub),
-                Expr.Lvalue.ComponentAccess compAccess
-                    => AppendExpression(o, compAccess.Structure, OpTable.ShouldBracket(compAccess)).Append('.').Append(compAccess.ComponentName),
-                Expr.Lvalue.VariableReference variable => AppendVariableReference(o, variable, convertInitToCompoundLiteral),
-                Expr.BinaryOperation opBin => AppendOperationBinary(o, opBin),
-                Expr.UnaryOperation opUn => AppendOperationUnary(o, opUn),
+                Expr.Lvalue.VariableReference variable => AppendVariableReference(o, variable,
+                    convertInitToCompoundLiteral || _openOperations.Count != start),
                 Expr.BuiltinFdf fdf => AppendBuiltinFdf(o, fdf),
                 _ => throw expr.ToUnmatchedException(),
             };
+            if (bracket) {
+                o.Append(')');
+            }
 
-            StringBuilder AppendLiteralBoolean(bool b)
-            {
-                _includes.Ensure(IncludeSet.StdBool);
-                return o.Append(b ? "true" : "false");
+            // Close the operations whose operands have been written, until one has a second operand to write.
+            while (true) {
+                if (_openOperations.Count == start) {
+                    return o;
+                }
+                (expr, bracket, bool secondOperandWritten) = _openOperations.Pop();
+                if (secondOperandWritten) {
+                    EndOperation(o, expr);
+                } else if (CloseOperation(o, expr, out bool bracketOperand) is { } operand) {
+                    _openOperations.Push((expr, bracket, true));
+                    (expr, bracket) = (operand, bracketOperand);
+                    break;
+                }
+                if (bracket) {
+                    o.Append(')');
+                }
             }
-        });
+        }
+    }
 
-    StringBuilder AppendVariableReference(StringBuilder o, Expr.Lvalue.VariableReference variable, bool convertInitToCompoundLiteral)
+    // Writes what comes before the first operand of an operation.
+    // Returns the first operand and whether to bracket it, or null if the expression isn't an operation.
+    Expr? OpenOperation(StringBuilder o, Expr expr, bool bracket, out bool bracketOperand)
     {
-        if (convertInitToCompoundLiteral
-         && variable.Meta.Scope.GetSymbol<Symbol.Constant>(variable.Name) is { HasValue: true } s
-         && s.Value.Type is ArrayType or StructureType) {
-            o.Append(Format.Code, $"({CreateTypeInfo(variable.Meta.Scope, s.Value.Type)})");
+        switch (expr) {
+        case ParenExpr b:
+            // Parentheses bracket their contained expression, unless the expression is already bracketed.
+            bracketOperand = !bracket;
+            return b.ContainedExpression;
+        case Expr.BinaryOperation opBin when IsStringComparison(opBin):
+            _includes.Ensure(IncludeSet.String);
+            o.Append(OpTable.Get(opBin).Prefix).Append("strcmp(");
+            bracketOperand = false;
+            return opBin.Left;
+        case Expr.BinaryOperation opBin:
+            o.Append(OpTable.Get(opBin).Prefix);
+            bracketOperand = OpTable.ShouldBracketBinary(opBin).bracketLeft;
+            return opBin.Left;
+        case Expr.UnaryOperation opUn: {
+            var op = OpTable.Get(opUn);
+            o.Append(op.Prefix);
+            if (opUn.Operator is UnaryOperator.Cast cast) {
+                o.Append(CreateTypeInfo(opUn.Meta.Scope, cast.Target)).Append(op.Infix);
+            }
+            bracketOperand = OpTable.ShouldBracketUnary(opUn);
+            return opUn.Operand;
+        }
+        case Expr.Lvalue.ArraySubscript arrSub:
+            bracketOperand = OpTable.ShouldBracket(arrSub);
+            return arrSub.Array;
+        case Expr.Lvalue.ComponentAccess compAccess:
+            o.Append(OpTable.ComponentAccess.Prefix);
+            bracketOperand = OpTable.ShouldBracket(compAccess);
+            return compAccess.Structure;
+        default:
+            bracketOperand = false;
+            return null;
         }
-        return C.IsPointerParameter(variable)
-            ? AppendUnaryOperation(o, OpTable.Dereference, variable,
-                (o, v) => o.Append(ValidateIdentifier(v.Meta.Scope, v.Name)))
-            : o.Append(ValidateIdentifier(variable.Meta.Scope, variable.Name));
     }
 
-    StringBuilder AppendOperationBinary(StringBuilder o, Expr.BinaryOperation opBin)
+    // Writes what comes after the first operand of an operation opened by OpenOperation.
+    // Returns the second operand of a binary operation and whether to bracket it, the rest of which is written by EndOperation, or null if the operation is closed.
+    Expr? CloseOperation(StringBuilder o, Expr expr, out bool bracketOperand)
     {
-        if (opBin.Left.Value.Type.IsConvertibleTo(StringType.Instance)
-         && opBin.Right.Value.Type.IsConvertibleTo(StringType.Instance)
-         && IsStringComparisonOperator(opBin.Operator)) {
-            _includes.Ensure(IncludeSet.String);
-            return OpTable.Get(opBin).Append(o, TypeGeneratorFor(opBin.Meta.Scope), [
-                o => AppendExpression(AppendExpression(o.Append("strcmp("), opBin.Left).Append(", "), opBin.Right).Append(')'),
-                o => o.Append('0'),
-            ]);
+        bracketOperand = false;
+        switch (expr) {
+        case ParenExpr:
+            return null;
+        case Expr.BinaryOperation opBin when IsStringComparison(opBin):
+            o.Append(", ");
+            return opBin.Right;
+        case Expr.BinaryOperation opBin:
+            o.Append(OpTable.Get(opBin).Infix);
+            bracketOperand = OpTable.ShouldBracketBinary(opBin).bracketRight;
+            return opBin.Right;
+        case Expr.UnaryOperation opUn:
+            o.Append(OpTable.Get(opUn).Suffix);
+            return null;
+        case Expr.Lvalue.ArraySubscript arrSub:
+            AppendIndex(o, arrSub.Index);
+            return null;
+        case Expr.Lvalue.ComponentAccess compAccess: {
+            var op = OpTable.ComponentAccess;
+            o.Append(op.Infix).Append(compAccess.ComponentName).Append(op.Suffix);
+            return null;
+        }
+        default:
+            throw expr.ToUnmatchedException();
+        }
+    }
+
+    // Writes what comes after the second operand of a binary operation.
+    void EndOperation(StringBuilder o, Expr expr)
+    {
+        switch (expr) {
+        case Expr.BinaryOperation opBin when IsStringComparison(opBin): {
+            var op = OpTable.Get(opBin);
+            o.Append(')').Append(op.Infix).Append('0').Append(op.Suffix);
+            break;
+        }
+        case Expr.BinaryOperation opBin:
+            o.Append(OpTable.Get(opBin).Suffix);
+            break;
+        default:
+            throw expr.ToUnmatchedException();
         }
+    }
 
-        var (bracketLeft, bracketRight) = OpTable.ShouldBracketBinary(opBin);
-        return OpTable.Get(opBin).Append(o, TypeGeneratorFor(opBin.Meta.Scope), [
-            o => AppendExpression(o, opBin.Left, bracketLeft),
-            o => AppendExpression(o, opBin.Right, bracketRight),
-        ]);
+    StringBuilder AppendLiteralBoolean(StringBuilder o, bool b)
+    {
+        _includes.Ensure(IncludeSet.StdBool);
+        return o.Append(b ? "true" : "false");
     }
 
+    StringBuilder AppendVariableReference(StringBuilder o, Expr.Lvalue.VariableReference variable, bool convertInitToCompoundLiteral)
+    {
+        if (variable.Symbol is { HasValue: true, Value: Symbol.Constant { Type: ArrayType or StructureType } constant }) {
+            if (_constantForms.TryGetValue(constant, out var c) && c.Form is ConstantForm.Object) {
+                // Arrays can't be initialized from another array, so initializers repeat the value of array objects.
+                if (!convertInitToCompoundLiteral && constant.Type is ArrayType) {
+                    return AppendInitializer(o, c.Value);
+                }
+            } else if (convertInitToCompoundLiteral) {
+                o.Append(Format.Code, $"({CreateTypeInfo(variable.Meta.Scope, constant.Type)})");
+            }
+        }
+        // A pointer parameter has the precedence of a dereference, so it is never bracketed.
+        return parameterPassing.IsPointerParameter(variable)
+            ? o.Append(OpTable.Dereference.Prefix).Append(ValidateVariableName(variable)).Append(OpTable.Dereference.Suffix)
+            : o.Append(ValidateVariableName(variable));
+    }
+
+    // Unresolved references are errors, but still generate code.
+    string ValidateVariableName(Expr.Lvalue.VariableReference variable) => variable.Symbol.HasValue
+        ? ValidateIdentifier(variable.Meta.Scope, variable.Symbol.Value)
+        : ValidateIdentifier(variable.Meta.Scope, variable.Name);
+
+    static bool IsStringComparison(Expr.BinaryOperation opBin)
+        => opBin.Left.Value.Type.IsConvertibleTo(StringType.Instance)
+        && opBin.Right.Value.Type.IsConvertibleTo(StringType.Instance)
+        && IsStringComparisonOperator(opBin.Operator);
+
     static bool IsStringComparisonOperator(BinaryOperator b) => b
         is BinaryOperator.Equal
      or BinaryOperator.GreaterThan
@@ -412,10 +681,8 @@ sealed partial class CodeGenerator(Messenger messenger)
      or BinaryOperator.LessThanOrEqual
      or BinaryOperator.NotEqual;
 
-    StringBuilder AppendOperationUnary(StringBuilder o, Expr.UnaryOperation opUn)
-        => OpTable.Get(opUn).Append(o, TypeGeneratorFor(opUn.Meta.Scope), [
-            o => AppendExpression(o, opUn.Operand, OpTable.ShouldBracketUnary(opUn)),
-        ]);
+    StringBuilder AppendUnaryOperation(StringBuilder o, OperatorInfo op, Expr operand)
+        => AppendExpression(o.Append(op.Prefix), operand, OpTable.ShouldBracketOperand(op, operand)).Append(op.Suffix);
 
     #endregion Expressions
 
@@ -425,12 +692,18 @@ sealed partial class CodeGenerator(Messenger messenger)
     {
         const string ParameterSeparator = ", ";
 
-        o.Append(Format.Code, $"{ValidateIdentifier(call.Meta.Scope, call.Callee)}(");
-        foreach (var param in call.Parameters) {
-            if (C.RequiresPointer(param.Mode, param.Value.Value.Type) && !C.IsPointerParameter(param.Value)) {
-                AppendUnaryOperation(o, OpTable.AddressOf, param.Value, AppendExpression);
-            } else {
+        o.Append(call.Symbol.HasValue
+            ? ValidateIdentifier(call.Meta.Scope, call.Symbol.Value)
+            : ValidateIdentifier(call.Meta.Scope, call.Callee)).Append('(');
+        for (int i = 0; i < call.Parameters.Count; ++i) {
+            var param = call.Parameters[i];
+            if (!parameterPassing.IsByPointer(call, i)) {
                 AppendExpression(o, param.Value);
+            } else if (parameterPassing.IsPointerParameter(param.Value)) {
+                // Pointer parameters are forwarded as they are.
+                o.Append(ValidateVariableName((Expr.Lvalue.VariableReference)param.Value));
+            } else {
+                AppendUnaryOperation(o, OpTable.AddressOf, param.Value);
             }
             o.Append(ParameterSeparator);
         }
@@ -440,26 +713,69 @@ sealed partial class CodeGenerator(Messenger messenger)
         return o.Append(')');
     }
 
-    static StringBuilder AppendFileHeader(StringBuilder o, Algorithm algorithm) => o.AppendLine(Format.Code, $"""
+    static void WriteFileHeader(TextWriter output, Algorithm algorithm) => output.WriteLine(string.Create(Format.Code, $"""
         /** @file
          * @brief {algorithm.Title}
          * @author {Environment.UserName}
          * @date {DateOnly.FromDateTime(DateTime.Now).ToString(Format.Date)}
          */
 
-        """);
+        """));
 
     TypeInfo CreateTypeInfo(Scope scope, EvaluatedType type)
     {
-        var info = TypeInfo.Create(type, new(scope, Msger, KwTable,
-            ToGenerator<Expr>(AppendExpression),
-            ToGenerator<Expr>((o, e) => AppendExpressionAlter(o, e, OpTable.Add, 1, (l, r) => l + r))));
+        if (_typeInfos.TryGetValue(type, out var info)) {
+            return info;
+        }
+        TypeInfoKey key = new(scope, type);
+        if (_scopedTypeInfos.TryGetValue(key, out info)) {
+            // A type info that contains this one depends on the scope as well.
+            _typeInfoRenames.Renamed = true;
+            return info;
+        }
+        // Not added before it is created, since creating it can generate expressions that create other type infos.
+        bool renamedBefore = _typeInfoRenames.Renamed;
+        _typeInfoRenames.Renamed = false;
+        info = TypeInfo.Create(type, new(scope, Msger, _typeInfoRenames,
+            _genExpr ??= ToGenerator<Expr>(AppendExpression),
+            _genExprAdd1 ??= ToGenerator<Expr>((o, e) => AppendExpressionAlter(o, e, OpTable.Add, 1, (l, r) => l + r))));
+        if (_typeInfoRenames.Renamed) {
+            // Another scope may rename differently, or must report the renaming again.
+            _scopedTypeInfos[key] = info;
+        } else {
+            _typeInfos[type] = info;
+        }
+        _typeInfoRenames.Renamed |= renamedBefore;
         foreach (string header in info.RequiredHeaders) {
             _includes.Ensure(header);
         }
         return info;
     }
 
+    // Types are interned, so they are compared by reference. This keeps apart equal types that are written differently.
+    readonly struct TypeInfoKey(Scope scope, EvaluatedType type) : IEquatable<TypeInfoKey>
+    {
+        readonly Scope _scope = scope;
+        readonly EvaluatedType _type = type;
+
+        public bool Equals(TypeInfoKey other) => ReferenceEquals(_scope, other._scope) && ReferenceEquals(_type, other._type);
+        public override bool Equals(object? obj) => obj is TypeInfoKey other && Equals(other);
+        public override int GetHashCode() => HashCode.Combine(RuntimeHelpers.GetHashCode(_scope), RuntimeHelpers.GetHashCode(_type));
+    }
+
+    // Records whether the identifiers it validates were renamed.
+    sealed class RenameTracker(CodeGeneration.KeywordTable kwTable) : CodeGeneration.KeywordTable
+    {
+        public bool Renamed { get; set; }
+
+        public string Validate(Scope scope, Range location, string ident, Messenger msger)
+        {
+            var valid = kwTable.Validate(scope, location, ident, msger);
+            Renamed |= valid != ident;
+            return valid;
+        }
+    }
+
     StringBuilder AppendExpressionAlter<T>(
         StringBuilder o,
         Expr left,
@@ -470,10 +786,8 @@ sealed partial class CodeGenerator(Messenger messenger)
     // Collapse literals
         => collapseLiterals is not null && GetExpressionObviousValue(left) is { HasValue: true } v
             ? o.Append(collapseLiterals((T)v.Value, right).ToStringFmt(Format.Code))
-            : @operator.Append(o, TypeGeneratorFor(left.Meta.Scope), [
-                o => AppendExpression(o, left, OpTable.ShouldBracketOperand(@operator, left)),
-                o => o.Append(right.ToStringFmt(Format.Code)),
-            ]);
+            : AppendExpression(o.Append(@operator.Prefix), left, OpTable.ShouldBracketOperand(@operator, left))
+               .Append(@operator.Infix).Append(right.ToStringFmt(Format.Code)).Append(@operator.Suffix);
 
     static ValueOption<object> GetExpressionObviousValue(Expr expr)
         => expr is Expr.Literal
@@ -482,11 +796,16 @@ sealed partial class CodeGenerator(Messenger messenger)
             ? v
             : default;
 
-    protected override TypeGenerator TypeGeneratorFor(Scope scope)
-        => type => CreateTypeInfo(scope, type);
-
     StringBuilder Indent(StringBuilder o) => Indentation.Indent(o);
 
+    // Speculative generation gives up on deep nesting, and the definition is generated again on the compilation thread.
+    void EnsureSufficientStack()
+    {
+        if (_speculative) {
+            RuntimeHelpers.EnsureSufficientExecutionStack();
+        }
+    }
+
     StringBuilder SetGroup(StringBuilder o, Group newGroup)
     {
         if (_currentGroup != newGroup) {
@@ -525,6 +844,7 @@ sealed partial class CodeGenerator(Messenger messenger)
     {
         None,
         Macros,
+        Constants,
         Types,
         Prototypes,
         Main,
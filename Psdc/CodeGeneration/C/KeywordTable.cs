@@ -1,3 +1,5 @@
+using System.Collections.Frozen;
+
 using Scover.Psdc.Pseudocode;
 using Scover.Psdc.Messages;
 
@@ -23,7 +25,7 @@ sealed class KeywordTable : CodeGeneration.KeywordTable
         return ident;
     }
 
-    static readonly HashSet<string> keywords = [
+    static readonly FrozenSet<string> keywords = new[] {
         "_Alignas",
         "_Alignof",
         "_Atomic",
@@ -83,5 +85,5 @@ sealed class KeywordTable : CodeGeneration.KeywordTable
         "void",
         "volatile",
         "while",
-    ];
+    }.ToFrozenSet();
 }
@@ -5,42 +5,40 @@ using static Scover.Psdc.StaticAnalysis.SemanticNode;
 
 namespace Scover.Psdc.CodeGeneration.C;
 
-sealed class OperatorTable : CodeGeneration.OperatorTable
+sealed class OperatorTable(ParameterPassing parameterPassing) : CodeGeneration.OperatorTable
 {
-    public static OperatorTable Instance { get; } = new();
-
     // Precedence and associativity extracted from the official C operator precedence table
     // https://en.cppreference.com/w/c/language/operator_precedence
 
-    public OperatorInfo AddressOf { get; } = new(RightToLeft, 2, 1, Prefix('&'));
-    public OperatorInfo BitwiseAnd { get; } = new(LeftToRight, 8, 2, Infix("&"));
-    public OperatorInfo BitwiseNot { get; } = new(LeftToRight, 2, 1, Prefix('~'));
-    public OperatorInfo BitwiseOr { get; } = new(LeftToRight, 9, 2, Infix("|"));
-    public OperatorInfo BitwiseXor { get; } = new(LeftToRight, 9, 2, Infix('^'));
-    public OperatorInfo Dereference { get; } = new(RightToLeft, 2, 1, Prefix('*'));
-    public OperatorInfo SizeOf { get; } = new(RightToLeft, 2, 1, Prefix("sizeof "));
-    public override OperatorInfo Add { get; } = new(LeftToRight, 4, 2, Infix('+'));
-    public override OperatorInfo And { get; } = new(LeftToRight, 11, 2, Infix("&&"));
-    public override OperatorInfo ArraySubscript { get; } = new(LeftToRight, 1, 2, (o, _, p) => p[1](p[0](o).Append('[')).Append(']'));
-    public override OperatorInfo Cast(EvaluatedType target) => new(RightToLeft, 2, 1, (o, typeGen, p) => p[0](o.Append(Format.Code, $"({typeGen(target)})")));
-    public override OperatorInfo ComponentAccess { get; } = new(LeftToRight, 1, 2, (o, _, p) => p[1](p[0](o).Append('.')));
-    public override OperatorInfo Divide { get; } = new(LeftToRight, 3, 2, Infix('/'));
-    public override OperatorInfo Equal { get; } = new(LeftToRight, 7, 2, Infix("=="));
-    public override OperatorInfo FunctionCall { get; } = new(LeftToRight, 1, -1, (o, _, p) => p[0](o).Append('(').AppendJoin(", ", p.Skip(1)).Append(')'));
-    public override OperatorInfo GreaterThan { get; } = new(LeftToRight, 6, 2, Infix('>'));
-    public override OperatorInfo GreaterThanOrEqual { get; } = new(LeftToRight, 6, 2, Infix(">="));
-    public override OperatorInfo LessThan { get; } = new(LeftToRight, 6, 2, Infix("<"));
-    public override OperatorInfo LessThanOrEqual { get; } = new(LeftToRight, 6, 2, Infix("<="));
-    public override OperatorInfo Mod { get; } = new(LeftToRight, 3, 2, Infix('%'));
-    public override OperatorInfo Multiply { get; } = new(LeftToRight, 3, 2, Infix('*'));
-    public override OperatorInfo Not { get; } = new(RightToLeft, 2, 1, Prefix('!'));
-    public override OperatorInfo NotEqual { get; } = new(LeftToRight, 7, 2, Infix("!="));
-    public override OperatorInfo Or { get; } = new(LeftToRight, 12, 2, Infix("||"));
-    public override OperatorInfo Subtract { get; } = new(LeftToRight, 4, 2, Infix('-'));
-    public override OperatorInfo UnaryMinus { get; } = new(RightToLeft, 2, 1, Prefix('-'));
-    public override OperatorInfo UnaryPlus { get; } = new(RightToLeft, 2, 1, Prefix('+'));
+    public OperatorInfo AddressOf { get; } = Prefix(RightToLeft, 2, "&");
+    public OperatorInfo BitwiseAnd { get; } = Infix(LeftToRight, 8, "&");
+    public OperatorInfo BitwiseNot { get; } = Prefix(LeftToRight, 2, "~");
+    public OperatorInfo BitwiseOr { get; } = Infix(LeftToRight, 9, "|");
+    public OperatorInfo BitwiseXor { get; } = Infix(LeftToRight, 9, "^");
+    public OperatorInfo Dereference { get; } = Prefix(RightToLeft, 2, "*");
+    public OperatorInfo SizeOf { get; } = Prefix(RightToLeft, 2, "sizeof ");
+    public override OperatorInfo Add { get; } = Infix(LeftToRight, 4, "+");
+    public override OperatorInfo And { get; } = Infix(LeftToRight, 11, "&&");
+    public override OperatorInfo ArraySubscript { get; } = new(LeftToRight, 1, 2, "", "[", "]");
+    public override OperatorInfo Cast { get; } = new(RightToLeft, 2, 2, "(", ")", "");
+    public override OperatorInfo ComponentAccess { get; } = new(LeftToRight, 1, 2, "", ".", "");
+    public override OperatorInfo Divide { get; } = Infix(LeftToRight, 3, "/");
+    public override OperatorInfo Equal { get; } = Infix(LeftToRight, 7, "==");
+    public override OperatorInfo FunctionCall { get; } = new(LeftToRight, 1, -1, "", "(", ")");
+    public override OperatorInfo GreaterThan { get; } = Infix(LeftToRight, 6, ">");
+    public override OperatorInfo GreaterThanOrEqual { get; } = Infix(LeftToRight, 6, ">=");
+    public override OperatorInfo LessThan { get; } = Infix(LeftToRight, 6, "<");
+    public override OperatorInfo LessThanOrEqual { get; } = Infix(LeftToRight, 6, "<=");
+    public override OperatorInfo Mod { get; } = Infix(LeftToRight, 3, "%");
+    public override OperatorInfo Multiply { get; } = Infix(LeftToRight, 3, "*");
+    public override OperatorInfo Not { get; } = Prefix(RightToLeft, 2, "!");
+    public override OperatorInfo NotEqual { get; } = Infix(LeftToRight, 7, "!=");
+    public override OperatorInfo Or { get; } = Infix(LeftToRight, 12, "||");
+    public override OperatorInfo Subtract { get; } = Infix(LeftToRight, 4, "-");
+    public override OperatorInfo UnaryMinus { get; } = Prefix(RightToLeft, 2, "-");
+    public override OperatorInfo UnaryPlus { get; } = Prefix(RightToLeft, 2, "+");
 
-    public override int GetPrecedence(Expr expr) => C.IsPointerParameter(expr)
+    public override int GetPrecedence(Expr expr) => parameterPassing.IsPointerParameter(expr)
         ? Dereference.Precedence
         : base.GetPrecedence(expr);
 
@@ -70,7 +68,7 @@ sealed class OperatorTable : CodeGeneration.OperatorTable
     protected override OperatorInfo Get(UnaryOperator op, EvaluatedType operandType)
     {
         return op switch {
-            UnaryOperator.Cast c => Cast(c.Target),
+            UnaryOperator.Cast => Cast,
             UnaryOperator.Minus => UnaryMinus,
             UnaryOperator.Plus => UnaryPlus,
             UnaryOperator.Not => UseLogic() ? Not : BitwiseNot,
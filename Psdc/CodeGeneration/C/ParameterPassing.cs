@@ -0,0 +1,357 @@
+using Scover.Psdc.Pseudocode;
+using Scover.Psdc.Parsing;
+
+using static Scover.Psdc.StaticAnalysis.SemanticNode;
+
+namespace Scover.Psdc.CodeGeneration.C;
+
+/// <summary>
+/// How the parameters of callables are passed in the generated C.
+/// </summary>
+/// <param name="maxCopySize">The size in bytes above which input structure parameters are passed by const pointer rather than copied, or a negative value to always copy them.</param>
+/// <remarks>
+/// Output and input-output parameters are passed by pointer. Input arrays and lengthed strings decay to pointers anyway, so only structures are ever copied.
+/// A structure is passed by const pointer only if the callable never modifies it and every call passes an lvalue, whose address can be taken.
+/// That lvalue must not be part of a variable the same call passes by writable pointer too, or the callable would see its writes through the const pointer.
+/// Also tells which constants are passed as arrays or strings, which decay to pointers that aren't const.
+/// </remarks>
+sealed class ParameterPassing(int maxCopySize)
+{
+    /// <summary>The default size above which input structures are passed by const pointer: two pointers, what most ABIs pass in registers.</summary>
+    public const int DefaultMaxCopySize = 16;
+
+    // The input parameters passed by const pointer, from both the declarations and the definitions of the callables, since they have distinct symbols.
+    readonly HashSet<Symbol.Parameter> _byConstPointer = new(ReferenceEqualityComparer.Instance);
+    readonly HashSet<Symbol.Constant> _passedAsWritable = new(ReferenceEqualityComparer.Instance);
+
+    /// <summary>Chooses the input parameters passed by const pointer.</summary>
+    /// <remarks>Must be called before generating, then only read, possibly concurrently.</remarks>
+    public void Choose(Algorithm algorithm)
+    {
+        // Parameters are identified by their callable name and their position, which declarations, definitions and calls agree on.
+        HashSet<Symbol.Parameter> modified = new(ReferenceEqualityComparer.Instance);
+        HashSet<(Ident Callable, int Index)> copied = [];
+        foreach (var decl in algorithm.Declarations) {
+            switch (decl) {
+            case Declaration.CallableDefinition def:
+                AddUses(modified, copied, _passedAsWritable, def.Block);
+                break;
+            case Declaration.MainProgram main:
+                AddUses(modified, copied, _passedAsWritable, main.Block);
+                break;
+            }
+        }
+
+        if (maxCopySize < 0) {
+            return;
+        }
+
+        HashSet<(Ident Callable, int Index)> chosen = [];
+        foreach (var def in algorithm.Declarations.OfType<Declaration.CallableDefinition>()) {
+            for (int i = 0; i < def.Symbol.Parameters.Count; ++i) {
+                var param = def.Symbol.Parameters[i];
+                if (param.Mode == ParameterMode.In && param.Type is StructureType type
+                 && Layout(type).Size > maxCopySize
+                 && !modified.Contains(param)) {
+                    chosen.Add((def.Symbol.Name, i));
+                } else {
+                    copied.Add((def.Symbol.Name, i));
+                }
+            }
+        }
+        chosen.ExceptWith(copied); // Also excludes the parameters of redefined callables whose definitions disagree.
+
+        foreach (var decl in algorithm.Declarations) {
+            var callable = decl switch {
+                Declaration.Callable c => c.Symbol,
+                Declaration.CallableDefinition def => def.Symbol,
+                _ => null,
+            };
+            for (int i = 0; i < callable?.Parameters.Count; ++i) {
+                if (chosen.Contains((callable.Name, i))) {
+                    _byConstPointer.Add(callable.Parameters[i]);
+                }
+            }
+        }
+    }
+
+    public bool IsByPointer(Symbol.Parameter param) => C.RequiresPointer(param.Mode, param.Type) || IsByConstPointer(param);
+
+    public bool IsByConstPointer(Symbol.Parameter param) => _byConstPointer.Contains(param);
+
+    /// <summary>Whether a constant, or a part of it, is passed to a callable as an array or a string. Its C object can't be const then.</summary>
+    public bool IsPassedAsWritable(Symbol.Constant constant) => _passedAsWritable.Contains(constant);
+
+    public bool IsPointerParameter(Expr expr)
+        => expr is Expr.Lvalue.VariableReference { Symbol: { HasValue: true, Value: Symbol.Parameter param } }
+        && IsByPointer(param);
+
+    /// <summary>Whether the argument at an index of a call is passed by pointer.</summary>
+    public bool IsByPointer(Expr.Call call, int index)
+    {
+        var arg = call.Parameters[index];
+        return C.RequiresPointer(arg.Mode, arg.Value.Value.Type)
+            || call.Symbol is { HasValue: true, Value.Parameters: var parameters } && index < parameters.Count && IsByConstPointer(parameters[index]);
+    }
+
+    // The size and alignment of a type in the generated C, on a typical 64-bit target.
+    static (int Size, int Alignment) Layout(EvaluatedType type)
+    {
+        switch (type) {
+        case BooleanType or CharacterType:
+            return (1, 1);
+        case IntegerType or RealType:
+            return (4, 4);
+        case StringType or FileType:
+            return (8, 8);
+        case LengthedStringType s:
+            return (s.Length + 1, 1);
+        case ArrayType a: {
+            var item = Layout(a.ItemType);
+            return (item.Size * a.Length.Value, item.Alignment);
+        }
+        case StructureType s: {
+            int size = 0, alignment = 1;
+            foreach (var component in s.Components.Map.Values) {
+                var c = Layout(component);
+                size = AlignUp(size, c.Alignment) + c.Size;
+                alignment = Math.Max(alignment, c.Alignment);
+            }
+            return (AlignUp(size, alignment), alignment);
+        }
+        default:
+            return (0, 1);
+        }
+
+        static int AlignUp(int offset, int alignment) => (offset + alignment - 1) / alignment * alignment;
+    }
+
+    // Adds the parameters and the constants a block modifies, and the parameters some call of the block passes a non-lvalue to.
+    // Passing an array or a string to a callable counts as modifying it, since it decays to a pointer that isn't const.
+    static void AddUses(HashSet<Symbol.Parameter> modified, HashSet<(Ident Callable, int Index)> copied, HashSet<Symbol.Constant> modifiedConstants, SemanticBlock block)
+    {
+        // The operands left to walk by AddReads.
+        Stack<Expr> reads = new();
+        foreach (var stmt in block) {
+            AddStatementUses(stmt);
+        }
+
+        void AddStatementUses(Statement stmt)
+        {
+            switch (stmt) {
+            case Nop:
+                break;
+            case Statement.ExpressionStatement e:
+                AddReads(e.Expression);
+                break;
+            case Statement.Alternative alternative:
+                AddReads(alternative.If.Condition);
+                AddBlockUses(alternative.If.Block);
+                foreach (var elseIf in alternative.ElseIfs) {
+                    AddReads(elseIf.Condition);
+                    AddBlockUses(elseIf.Block);
+                }
+                alternative.Else.Tap(@else => AddBlockUses(@else.Block));
+                break;
+            case Statement.Switch @switch:
+                AddReads(@switch.Expression);
+                foreach (var @case in @switch.Cases) {
+                    if (@case is Statement.Switch.Case.OfValue ofValue) {
+                        AddReads(ofValue.Value);
+                    }
+                    AddBlockUses(@case.Block);
+                }
+                break;
+            case Statement.Assignment assignment:
+                AddWrite(assignment.Target);
+                AddReads(assignment.Value);
+                break;
+            case Statement.DoWhileLoop doWhileLoop:
+                AddReads(doWhileLoop.Condition);
+                AddBlockUses(doWhileLoop.Block);
+                break;
+            case Statement.RepeatLoop repeatLoop:
+                AddReads(repeatLoop.Condition);
+                AddBlockUses(repeatLoop.Block);
+                break;
+            case Statement.WhileLoop whileLoop:
+                AddReads(whileLoop.Condition);
+                AddBlockUses(whileLoop.Block);
+                break;
+            case Statement.ForLoop forLoop:
+                AddWrite(forLoop.Variant);
+                AddReads(forLoop.Start);
+                AddReads(forLoop.End);
+                forLoop.Step.Tap(AddReads);
+                AddBlockUses(forLoop.Block);
+                break;
+            case Statement.Return ret:
+                ret.Value.Tap(AddReads);
+                break;
+            case Statement.LocalVariable local:
+                local.Value.Tap(AddInitializerReads);
+                break;
+            case Statement.Builtin.Ecrire ecrire:
+                AddReads(ecrire.ArgumentNomLog);
+                AddReads(ecrire.ArgumentExpression);
+                break;
+            case Statement.Builtin.EcrireEcran ecrireEcran:
+                foreach (var arg in ecrireEcran.Arguments) {
+                    AddReads(arg);
+                }
+                break;
+            case Statement.Builtin.Lire lire:
+                AddReads(lire.ArgumentNomLog);
+                AddWrite(lire.ArgumentVariable);
+                break;
+            case Statement.Builtin.LireClavier lireClavier:
+                AddWrite(lireClavier.ArgumentVariable);
+                break;
+            case Statement.Builtin.Assigner assigner:
+                AddWrite(assigner.ArgumentNomLog);
+                AddReads(assigner.ArgumentNomExt);
+                break;
+            // Opening and closing a file modifies its variable.
+            case Statement.Builtin.Fermer fermer:
+                AddWrite(fermer.ArgumentNomLog);
+                break;
+            case Statement.Builtin.OuvrirAjout ouvrirAjout:
+                AddWrite(ouvrirAjout.ArgumentNomLog);
+                break;
+            case Statement.Builtin.OuvrirEcriture ouvrirEcriture:
+                AddWrite(ouvrirEcriture.ArgumentNomLog);
+                break;
+            case Statement.Builtin.OuvrirLecture ouvrirLecture:
+                AddWrite(ouvrirLecture.ArgumentNomLog);
+                break;
+            default:
+                throw stmt.ToUnmatchedException();
+            }
+        }
+
+        void AddBlockUses(SemanticBlock block) => AddUses(modified, copied, modifiedConstants, block);
+
+        void AddInitializerReads(Initializer initializer)
+        {
+            switch (initializer) {
+            case Initializer.Braced braced:
+                foreach (var item in braced.Items) {
+                    AddInitializerReads(item.Value);
+                }
+                break;
+            case Expr expr:
+                AddReads(expr);
+                break;
+            default:
+                throw initializer.ToUnmatchedException();
+            }
+        }
+
+        void AddWrite(Expr target)
+        {
+            AddReads(target); // for the indexes
+            switch (GetVariable(target)) {
+            case Symbol.Parameter param:
+                modified.Add(param);
+                break;
+            case Symbol.Constant constant:
+                modifiedConstants.Add(constant);
+                break;
+            }
+        }
+
+        // Adds the structures a call passes along with a writable pointer to the same variable.
+        void AddAliasedArguments(Expr.Call call, Ident callable)
+        {
+            for (int i = 0; i < call.Parameters.Count; ++i) {
+                var arg = call.Parameters[i];
+                if (IsWritable(arg) || arg.Value.Value.Type is not StructureType || GetVariable(arg.Value) is not { } variable) {
+                    continue;
+                }
+                for (int j = 0; j < call.Parameters.Count; ++j) {
+                    if (j != i && IsWritable(call.Parameters[j]) && ReferenceEquals(GetVariable(call.Parameters[j].Value), variable)) {
+                        copied.Add((callable, i));
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Walks the operands with an explicit stack, so that deep expressions don't recurse.
+        void AddReads(Expr expr)
+        {
+            int start = reads.Count;
+            reads.Push(expr);
+            while (reads.Count != start) {
+                var operand = reads.Pop();
+                switch (operand) {
+                case ParenExpr p:
+                    reads.Push(p.ContainedExpression);
+                    break;
+                case Expr.Lvalue.ComponentAccess compAccess:
+                    reads.Push(compAccess.Structure);
+                    break;
+                case Expr.Lvalue.ArraySubscript arrSub:
+                    reads.Push(arrSub.Index);
+                    reads.Push(arrSub.Array);
+                    break;
+                case Expr.UnaryOperation opUn:
+                    reads.Push(opUn.Operand);
+                    break;
+                case Expr.BinaryOperation opBin:
+                    reads.Push(opBin.Right);
+                    reads.Push(opBin.Left);
+                    break;
+                case Expr.BuiltinFdf fdf:
+                    reads.Push(fdf.ArgumentNomLog);
+                    break;
+                case Expr.Call call:
+                    for (int i = 0; i < call.Parameters.Count; ++i) {
+                        var arg = call.Parameters[i];
+                        if (IsWritable(arg)) {
+                            AddWrite(arg.Value);
+                        } else {
+                            reads.Push(arg.Value);
+                        }
+                        if (call.Symbol.HasValue && arg.Value is not Expr.Lvalue) {
+                            copied.Add((call.Symbol.Value.Name, i));
+                        }
+                    }
+                    if (call.Symbol.HasValue) {
+                        AddAliasedArguments(call, call.Symbol.Value.Name);
+                    }
+                    break;
+                case Expr.Lvalue.VariableReference or Expr.Literal:
+                    break;
+                default:
+                    throw operand.ToUnmatchedException();
+                }
+            }
+        }
+    }
+
+    // Whether an argument is passed by a pointer the callable can write through.
+    static bool IsWritable(ParameterActual arg) => arg.Mode != ParameterMode.In || arg.Value.Value.Type is ArrayType or LengthedStringType;
+
+    // The variable an lvalue is part of.
+    static Symbol.Variable? GetVariable(Expr lvalue)
+    {
+        while (true) {
+            switch (lvalue) {
+            case ParenExpr p:
+                lvalue = p.ContainedExpression;
+                break;
+            case Expr.Lvalue.ComponentAccess compAccess:
+                lvalue = compAccess.Structure;
+                break;
+            case Expr.Lvalue.ArraySubscript arrSub:
+                lvalue = arrSub.Array;
+                break;
+            case Expr.Lvalue.VariableReference { Symbol.HasValue: true } variable:
+                return variable.Symbol.Value;
+            default:
+                return null;
+            }
+        }
+    }
+}
@@ -1,4 +1,5 @@
 using System.Diagnostics.CodeAnalysis;
+using System.Runtime.InteropServices;
 using System.Text;
 
 using Scover.Psdc.Pseudocode;
@@ -11,11 +12,18 @@ namespace Scover.Psdc.CodeGeneration;
 
 public static class CodeGenerator
 {
-    public static bool TryGet(string language, [NotNullWhen(true)] out Func<Messenger, Algorithm, string>? func)
+    /// <summary>Gets the code generator of a target language.</summary>
+    /// <param name="language">The target language name.</param>
+    /// <param name="func">The code generator, which writes the generated code of an algorithm to a text writer.</param>
+    /// <param name="maxDegreeOfParallelism">The maximum number of callable definitions to generate concurrently, or -1 for no limit. The generated code doesn't depend on it.</param>
+    /// <param name="constantObjects">Generate constants as objects and enumeration constants where possible, rather than as macros.</param>
+    /// <param name="maxCopySize">The size in bytes above which input structure parameters the callable doesn't modify are passed by const pointer rather than copied, or a negative value to always copy them.</param>
+    public static bool TryGet(string language, [NotNullWhen(true)] out Action<Messenger, Algorithm, TextWriter>? func, int maxDegreeOfParallelism = -1, bool constantObjects = false,
+        int maxCopySize = C.ParameterPassing.DefaultMaxCopySize)
     {
         switch (language.ToLower(Format.Code)) {
         case Language.CliOption.C:
-            func = (m, a) => new C.CodeGenerator(m).Generate(a);
+            func = (m, a, output) => new C.CodeGenerator(m, maxDegreeOfParallelism, constantObjects, new(maxCopySize)).Generate(a, output);
             return true;
         default:
             func = null;
@@ -24,7 +32,6 @@ public static class CodeGenerator
     }
 }
 delegate StringBuilder Appender<in T>(StringBuilder o, T node);
-delegate StringBuilder Appender(StringBuilder o);
 delegate string Generator<in T>(T node);
 abstract class CodeGenerator<TKwTable, TOpTable>(Messenger msger, TKwTable keywordTable, TOpTable operatorTable)
 where TKwTable : KeywordTable
@@ -37,30 +44,31 @@ where TOpTable : OperatorTable
     protected readonly TKwTable KwTable = keywordTable;
     protected readonly TOpTable OpTable = operatorTable;
 
-    protected string ValidateIdentifier(Scope scope, Ident ident) => KwTable.Validate(scope, ident, Msger);
-    protected string ValidateIdentifier(Scope scope, Range location, string ident) => KwTable.Validate(scope, location, ident, Msger);
-
-    public abstract string Generate(Algorithm algorithm);
+    // The target language name of each symbol, chosen on its first occurrence.
+    readonly Dictionary<Symbol, string> _symbolNames = new(ReferenceEqualityComparer.Instance);
 
-    protected abstract TypeGenerator TypeGeneratorFor(Scope scope);
-
-    protected StringBuilder AppendUnaryOperation<TExpr>(StringBuilder o, OperatorInfo op, TExpr operand, Appender<TExpr> appender) where TExpr : Expr =>
-        op.Append(o, TypeGeneratorFor(operand.Meta.Scope), [
-            o => AppendBetweenParens(o, OpTable.ShouldBracketOperand(op, operand), o => appender(o, operand)),
-        ]);
+    protected string ValidateIdentifier(Scope scope, Symbol symbol)
+    {
+        ref var name = ref CollectionsMarshal.GetValueRefOrAddDefault(_symbolNames, symbol, out bool exists);
+        return exists ? name! : name = KwTable.Validate(scope, symbol.Name, Msger);
+    }
 
-    protected static StringBuilder AppendBetweenParens(StringBuilder o, bool bracket, Action<StringBuilder> appender)
+    /// <summary>Adds the names chosen by another generator for symbols this generator hasn't named yet.</summary>
+    protected void MergeSymbolNames(CodeGenerator<TKwTable, TOpTable> other)
     {
-        if (bracket) {
-            o.Append('(');
+        foreach (var (symbol, name) in other._symbolNames) {
+            _symbolNames.TryAdd(symbol, name);
         }
-        appender(o);
-        if (bracket) {
-            o.Append(')');
-        }
-        return o;
     }
 
+    protected string ValidateIdentifier(Scope scope, Ident ident) => KwTable.Validate(scope, ident, Msger);
+    protected string ValidateIdentifier(Scope scope, Range location, string ident) => KwTable.Validate(scope, location, ident, Msger);
+
+    /// <summary>Generates the code of an algorithm.</summary>
+    /// <param name="algorithm">The algorithm.</param>
+    /// <param name="output">The writer the code is written to.</param>
+    public abstract void Generate(Algorithm algorithm, TextWriter output);
+
     protected StringBuilder AppendStatements(StringBuilder o, SemanticBlock statements)
     {
         foreach (Statement statement in statements) {
@@ -1,6 +1,4 @@
-﻿using System.Text;
-
-namespace Scover.Psdc.CodeGeneration;
+﻿namespace Scover.Psdc.CodeGeneration;
 
 sealed class IncludeSet
 {
@@ -11,17 +9,14 @@ sealed class IncludeSet
 
     readonly HashSet<string> _headers = [];
 
-    public StringBuilder AppendIncludeSection(StringBuilder o)
+    public void WriteIncludeSection(TextWriter output)
     {
-        if (_headers.Count == 0) {
-            return o;
-        }
-
         foreach (string header in _headers.Order()) {
-            o.AppendLine(Format.Code, $"#include {header}");
+            output.WriteLine($"#include {header}");
         }
-        return o;
     }
 
     public void Ensure(string name) => _headers.Add(name);
+
+    public void UnionWith(IncludeSet other) => _headers.UnionWith(other._headers);
 }
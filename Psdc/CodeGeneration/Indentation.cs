@@ -6,6 +6,8 @@ sealed class Indentation(int tabSize)
 {
     readonly int _tabSize = tabSize;
     const char Character = ' ';
+    // The indentation string of each level, created on first use.
+    readonly List<string> _indents = [""];
     int _level;
 
     public void Decrease() => _level--;
@@ -14,9 +16,9 @@ sealed class Indentation(int tabSize)
 
     public StringBuilder Indent(StringBuilder output)
     {
-        for (int i = 0; i < _level * _tabSize; i++) {
-            _ = output.Append(Character);
+        while (_indents.Count <= _level) {
+            _indents.Add(new(Character, _indents.Count * _tabSize));
         }
-        return output;
+        return output.Append(_indents[_level]);
     }
 }
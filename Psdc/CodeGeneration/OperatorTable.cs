@@ -3,31 +3,24 @@ using Scover.Psdc.Pseudocode;
 using static Scover.Psdc.StaticAnalysis.SemanticNode;
 using static Scover.Psdc.Pseudocode.Associativity;
 
-using System.Text;
-using System.Diagnostics;
-
 namespace Scover.Psdc.CodeGeneration;
 
-delegate TypeInfo TypeGenerator(EvaluatedType type);
-delegate StringBuilder OperatorInfoAppender(StringBuilder o, TypeGenerator typeGenerator, IReadOnlyList<Appender> @params);
+/// <summary>
+/// An operator of the target language.
+/// </summary>
+/// <remarks>An operation is written as the prefix, the first operand, the infix, the second operand, if any, then the suffix.</remarks>
 readonly record struct OperatorInfo
 {
     public OperatorInfo(
         Associativity associativity,
         int precedence,
         int arity,
-        OperatorInfoAppender append
-    ) => (Associativity, _append, Arity, Precedence) = (associativity, append, arity, precedence);
+        string prefix,
+        string infix,
+        string suffix
+    ) => (Associativity, Precedence, Arity, Prefix, Infix, Suffix) = (associativity, precedence, arity, prefix, infix, suffix);
 
     public Associativity Associativity { get; }
-    readonly OperatorInfoAppender _append;
-    public StringBuilder Append(StringBuilder o, TypeGenerator typeGenerator, IReadOnlyList<Appender> @params)
-    {
-        Debug.Assert(Arity < 0
-            ? @params.Count >= Arity * -1
-            : @params.Count == Arity);
-        return _append(o, typeGenerator, @params);
-    }
 
     /// <summary>
     /// Get the arity.
@@ -35,7 +28,15 @@ readonly record struct OperatorInfo
     /// <remarks>Negatives value indicate a minimum arity. Example: an arity of -5 means at least 5 arguments are expected.</remarks>
     public int Arity { get; }
     public int Precedence { get; }
-    public static OperatorInfo None { get; } = new(LeftToRight, int.MinValue, 0, (o, _, _) => o);
+
+    /// <summary>Written before the first operand.</summary>
+    public string Prefix { get; }
+    /// <summary>Written between the first and the second operand.</summary>
+    public string Infix { get; }
+    /// <summary>Written after the last operand.</summary>
+    public string Suffix { get; }
+
+    public static OperatorInfo None { get; } = new(LeftToRight, int.MinValue, 0, "", "", "");
 }
 abstract class OperatorTable
 {
@@ -97,7 +98,8 @@ abstract class OperatorTable
     public abstract OperatorInfo Add { get; }
     public abstract OperatorInfo And { get; }
     public abstract OperatorInfo ArraySubscript { get; }
-    public abstract OperatorInfo Cast(EvaluatedType target);
+    /// <summary>The cast operator. Its first operand is the target type.</summary>
+    public abstract OperatorInfo Cast { get; }
     public abstract OperatorInfo ComponentAccess { get; }
     public abstract OperatorInfo Divide { get; }
     public abstract OperatorInfo Equal { get; }
@@ -115,21 +117,9 @@ abstract class OperatorTable
     public abstract OperatorInfo UnaryMinus { get; }
     public abstract OperatorInfo UnaryPlus { get; }
 
-    protected static OperatorInfoAppender Infix(string @operator) => (o, _, p) => {
-        Debug.Assert(p.Count == 2);
-        return p[1](p[0](o).Append(' ').Append(@operator).Append(' '));
-    };
-    protected static OperatorInfoAppender Infix(char @operator) => (o, _, p) => {
-        Debug.Assert(p.Count == 2);
-        return p[1](p[0](o).Append(' ').Append(@operator).Append(' '));
-    };
+    protected static OperatorInfo Infix(Associativity associativity, int precedence, string @operator)
+        => new(associativity, precedence, 2, "", $" {@operator} ", "");
 
-    protected static OperatorInfoAppender Prefix(string @operator) => (o, _, p) => {
-        Debug.Assert(p.Count == 1);
-        return p[0](o.Append(@operator));
-    };
-    protected static OperatorInfoAppender Prefix(char @operator) => (o, _, p) => {
-        Debug.Assert(p.Count == 1);
-        return p[0](o.Append(@operator));
-    };
+    protected static OperatorInfo Prefix(Associativity associativity, int precedence, string @operator)
+        => new(associativity, precedence, 1, @operator, "", "");
 }
@@ -10,32 +10,45 @@ public sealed class Lexer
     static IEnumerable<T> GetRules<T>(IEnumerable<Ruled<T>> ruled) where T : TokenRule => ruled.SelectMany(r => r.Rules);
     static IEnumerable<TokenRule> GetRules(IEnumerable<Ruled<TokenRule>> ruled) => ruled.SelectMany(r => r.Rules);
 
-    static readonly HashSet<TokenType> ignoredTokens = [CommentMultiline, CommentSingleline];
+    static readonly TokenTypeSet ignoredTokens = TokenTypeSet.Of(CommentMultiline, CommentSingleline);
 
-    static readonly IReadOnlyList<TokenRule> rules =
+    static readonly TokenRule[] rules =
         // Variable length
         GetRules(new Ruled<TokenRule>[] { CommentMultiline, CommentSingleline, LiteralReal, LiteralInteger, LiteralString, LiteralCharacter })
             // Maximum munch
-           .Concat(GetRules(Keyword.Instances).OrderByDescending(r => r.Expected.Length))
-           .Concat(GetRules(Punctuation.Instances).OrderByDescending(r => r.Expected.Length))
+           .Append(new TrieTokenRule(GetRules(Keyword.Instances)))
+           .Append(new TrieTokenRule(GetRules(Punctuation.Instances)))
             // Identifiers after keywords and punctuation/operators (just to be sure that they won't be lexed as identifiers)
            .Concat(Identifier.Rules)
            .ToArray();
 
-    Lexer(Messenger msger, string input)
+    const int AsciiCharCount = 128;
+
+    // First-character dispatch table: the rules that can match a token starting with a given ASCII character, in order of priority.
+    static readonly TokenRule[][] asciiRules = Enumerable.Range(0, AsciiCharCount)
+       .Select(c => rules.Where(r => r.CanStartWith((char)c)).ToArray())
+       .ToArray();
+
+    Lexer(Messenger msger, string input, NameTable names)
     {
         _msger = msger;
-        (_code, _sortedLineContinutationIndexes) = PreprocessLineContinuations(input);
+        _names = names;
+        (_code, _lineContinuationOffsets) = PreprocessLineContinuations(input);
     }
 
     readonly Messenger _msger;
-    readonly List<int> _sortedLineContinutationIndexes;
+    readonly NameTable _names;
+    // Offsets in the preprocessed code where line continuations were removed, in ascending order. Consecutive line continuations share the same offset.
+    // The original offset of a preprocessed offset is the preprocessed offset plus the cumulative length of the line continuations before it.
+    readonly int[] _lineContinuationOffsets;
     readonly string _code;
+    const int LineContinuationLength = 2;
     const int NaIndex = -1;
 
-    public static IEnumerable<Token> Lex(Messenger messenger, string input)
+    // The names of the identifiers are interned in names, which the static analyzer then needs to key symbols.
+    public static IEnumerable<Token> Lex(Messenger messenger, string input, NameTable names)
     {
-        Lexer t = new(messenger, input);
+        Lexer t = new(messenger, input, names);
 
         int i = 0;
         int iInvalidStart = NaIndex;
@@ -50,7 +63,9 @@ public sealed class Lexer
 
             if (token.HasValue) {
                 t.ReportInvalidToken(ref iInvalidStart, i);
-                if (!ignoredTokens.Contains(token.Value.Type)) {
+                if (token.Value.Type == Identifier) {
+                    yield return t.InternIdentifier(token.Value);
+                } else if (!ignoredTokens.Contains(token.Value.Type)) {
                     yield return token.Value with { Position = t.AdjustLocationForLineContinuations(token.Value.Position.Start, token.Value.Position.Length) };
                 }
                 i += token.Value.Position.Length;
@@ -64,7 +79,17 @@ public sealed class Lexer
 
         t.ReportInvalidToken(ref iInvalidStart, i);
 
-        yield return new Token(Eof, null, t.AdjustLocationForLineContinuations(i, 0));
+        yield return new Token(Eof, default, t.AdjustLocationForLineContinuations(i, 0));
+    }
+
+    Token InternIdentifier(Token identifier)
+    {
+        int nameId = _names.Intern(identifier.Value.Span, out var name);
+        return identifier with {
+            Value = name.AsMemory(),
+            NameId = nameId,
+            Position = AdjustLocationForLineContinuations(identifier.Position.Start, identifier.Position.Length),
+        };
     }
 
     void ReportInvalidToken(ref int iInvalidStart, int i)
@@ -77,61 +102,65 @@ public sealed class Lexer
 
     ValueOption<Token> Lex(int offset)
     {
-        foreach (var rule in rules) {
-            if (rule.Extract(_code, offset) is { HasValue: true } token) {
-                return token;
+        char c = _code[offset];
+        if (c < AsciiCharCount) {
+            foreach (var rule in asciiRules[c]) {
+                if (rule.Extract(_code, offset) is { HasValue: true } token) {
+                    return token;
+                }
+            }
+        } else {
+            foreach (var rule in rules) {
+                if (rule.CanStartWith(c) && rule.Extract(_code, offset) is { HasValue: true } token) {
+                    return token;
+                }
             }
         }
         return default;
     }
 
-    static (string, List<int>) PreprocessLineContinuations(string input)
+    static (string, int[]) PreprocessLineContinuations(string input)
     {
         if (input.Length == 0) {
             return ("", []);
         }
 
         var preprocessedCode = new char[input.Length];
-        List<int> sortedLineContinuationsIndexes = [];
+        List<int> lineContinuationOffsets = [];
 
         int i = 0;
         for (int j = 0; j < input.Length; ++j) {
             if (input[j] == '\\' && j + 1 < input.Length && input[j + 1] == '\n') {
-                sortedLineContinuationsIndexes.Add(j++);
+                lineContinuationOffsets.Add(i);
+                ++j;
             } else {
                 preprocessedCode[i++] = input[j];
             }
         }
-        return (new(preprocessedCode.AsSpan()[..i]), sortedLineContinuationsIndexes);
+        return (new(preprocessedCode.AsSpan()[..i]), lineContinuationOffsets.ToArray());
     }
 
     LengthRange AdjustLocationForLineContinuations(int start, int length)
     {
-        start += MeasureLineContinuations(0, start);
-        length += MeasureLineContinuations(start, start + length);
-        return new(start, length);
+        int originalStart = GetOriginalOffset(start);
+        return new(originalStart, GetOriginalOffset(start + length) - originalStart);
     }
 
-    int MeasureLineContinuations(int start, int end)
-    {
-        const int LineContinuationLen = 2;
+    // A line continuation removed exactly at the offset is not counted: the result points to its backslash.
+    int GetOriginalOffset(int offset) => offset + LineContinuationLength * CountLineContinuationsBefore(offset);
 
-        int iFirstLc = _sortedLineContinutationIndexes.BinarySearch(start);
-        // If there's no line continuation after start
-        if (~iFirstLc == _sortedLineContinutationIndexes.Count) {
-            return 0;
-        }
-        if (iFirstLc < 0) {
-            iFirstLc = ~iFirstLc;
-        }
-        int iLastLc = iFirstLc;
-        for (int i = _sortedLineContinutationIndexes[iFirstLc]; iLastLc < _sortedLineContinutationIndexes.Count && i < end; ++i) {
-            if (i == _sortedLineContinutationIndexes[iLastLc]) {
-                ++iLastLc;
-                end += LineContinuationLen;
+    int CountLineContinuationsBefore(int offset)
+    {
+        // Lower bound: the offsets can contain duplicates, which Array.BinarySearch doesn't handle.
+        int low = 0, high = _lineContinuationOffsets.Length;
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (_lineContinuationOffsets[mid] < offset) {
+                low = mid + 1;
+            } else {
+                high = mid;
             }
         }
-
-        return LineContinuationLen * (iLastLc - iFirstLc);
+        return low;
     }
 }
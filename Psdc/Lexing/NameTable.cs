@@ -0,0 +1,75 @@
+namespace Scover.Psdc.Lexing;
+
+/// <summary>
+/// The identifier names of a compilation, each stored once and numbered by order of appearance.
+/// </summary>
+/// <remarks>Names are looked up by span, so interning a name that was already seen doesn't allocate.</remarks>
+public sealed class NameTable
+{
+    const int InitialCapacity = 64;
+
+    // Separate chaining: bucket heads and next links are indexes in _entries, plus one so that 0 means none.
+    int[] _buckets = new int[InitialCapacity];
+    Entry[] _entries = new Entry[InitialCapacity];
+    int _count;
+
+    readonly record struct Entry(string Name, int HashCode, int Next);
+
+    /// <summary>Adds a name to the table, if it isn't already there.</summary>
+    /// <param name="name">The name to intern.</param>
+    /// <param name="internedName">The instance of the name stored in the table.</param>
+    /// <returns>The id of <paramref name="name"/>, which is the same for every occurrence of it.</returns>
+    public int Intern(ReadOnlySpan<char> name, out string internedName)
+    {
+        int hashCode = string.GetHashCode(name);
+        int i = Find(name, hashCode);
+        if (i >= 0) {
+            internedName = _entries[i].Name;
+            return i;
+        }
+
+        if (_count == _entries.Length) {
+            Grow();
+        }
+        internedName = name.ToString();
+        ref int bucket = ref _buckets[GetBucket(hashCode)];
+        _entries[_count] = new(internedName, hashCode, bucket);
+        bucket = ++_count;
+        return _count - 1;
+    }
+
+    /// <summary>Gets the id of a name without adding it to the table.</summary>
+    /// <param name="name">The name to look up.</param>
+    /// <param name="id">Assigned to the id of <paramref name="name"/>, if it was interned.</param>
+    /// <returns>Whether <paramref name="name"/> was interned.</returns>
+    public bool TryGetId(ReadOnlySpan<char> name, out int id)
+    {
+        id = Find(name, string.GetHashCode(name));
+        return id >= 0;
+    }
+
+    int Find(ReadOnlySpan<char> name, int hashCode)
+    {
+        for (int i = _buckets[GetBucket(hashCode)] - 1; i >= 0; i = _entries[i].Next - 1) {
+            ref readonly var entry = ref _entries[i];
+            if (entry.HashCode == hashCode && name.SequenceEqual(entry.Name)) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    int GetBucket(int hashCode) => hashCode & (_buckets.Length - 1);
+
+    void Grow()
+    {
+        Array.Resize(ref _entries, _entries.Length * 2);
+        _buckets = new int[_entries.Length];
+        for (int i = 0; i < _count; ++i) {
+            ref var entry = ref _entries[i];
+            ref int bucket = ref _buckets[GetBucket(entry.HashCode)];
+            entry = entry with { Next = bucket };
+            bucket = i + 1;
+        }
+    }
+}
@@ -0,0 +1,27 @@
+namespace Scover.Psdc.Lexing;
+
+/// <summary>
+/// Scans a variable-length token at the start of some code.
+/// </summary>
+/// <param name="code">The code, starting at the first character of the token.</param>
+/// <returns>The length of the token, or 0 if there is no token of this kind at the start of <paramref name="code"/>.</returns>
+delegate int Scanner(ReadOnlySpan<char> code);
+
+/// <summary>
+/// Extracts a token using a hand-written scanner. The value of the token is the scanned text minus its delimiters.
+/// </summary>
+sealed class ScannerTokenRule(TokenType tokenType, Scanner scan, Predicate<char> canStartWith, int prefixLength, int suffixLength) : TokenRule
+{
+    public TokenType TokenType { get; } = tokenType;
+    public bool CanStartWith(char c) => canStartWith(c);
+    public ValueOption<Token> Extract(string code, int startIndex)
+    {
+        int length = scan(code.AsSpan(startIndex));
+        return length == 0
+            ? default
+            : new Token(
+                TokenType,
+                code.AsMemory(startIndex + prefixLength, length - prefixLength - suffixLength),
+                new(startIndex, length)).Some();
+    }
+}
@@ -0,0 +1,100 @@
+namespace Scover.Psdc.Lexing;
+
+/// <summary>
+/// Scanners for variable-length tokens.
+/// </summary>
+/// <remarks>
+/// These replace the regular expressions that used to define <see cref="TokenType.Valued"/> tokens. They accept exactly the same language, but don't need to be compiled at startup, which matters under Native AOT where <c>RegexOptions.Compiled</c> falls back to the interpreter.
+/// </remarks>
+static class Scanners
+{
+    // /\*(.*?)\*/ (singleline)
+    public static int CommentMultiline(ReadOnlySpan<char> code)
+    {
+        if (!code.StartsWith("/*")) {
+            return 0;
+        }
+        int iEnd = code[2..].IndexOf("*/");
+        return iEnd == -1 ? 0 : iEnd + 4;
+    }
+
+    // //(.*)$ (multiline)
+    public static int CommentSingleline(ReadOnlySpan<char> code)
+    {
+        if (!code.StartsWith("//")) {
+            return 0;
+        }
+        int iEol = code.IndexOf('\n');
+        return iEol == -1 ? code.Length : iEol;
+    }
+
+    // [\p{L}_][\p{L}_0-9]*
+    public static int Identifier(ReadOnlySpan<char> code)
+    {
+        if (code.Length == 0 || !(code[0] == '_' || char.IsLetter(code[0]))) {
+            return 0;
+        }
+        int i = 1;
+        while (i < code.Length && TokenType.Valued.IsIdentifierChar(code[i])) {
+            ++i;
+        }
+        return i;
+    }
+
+    // \d+
+    public static int LiteralInteger(ReadOnlySpan<char> code) => CountDigits(code);
+
+    // \d*\.\d+
+    public static int LiteralReal(ReadOnlySpan<char> code)
+    {
+        int iDot = CountDigits(code);
+        if (iDot == code.Length || code[iDot] != '.') {
+            return 0;
+        }
+        int decimalCount = CountDigits(code[(iDot + 1)..]);
+        return decimalCount == 0 ? 0 : iDot + 1 + decimalCount;
+    }
+
+    // '((?:\\?.)+?)'
+    public static int LiteralCharacter(ReadOnlySpan<char> code) => ScanQuoted(code, '\'', 1);
+
+    // "((?:\\?.)*?)"
+    public static int LiteralString(ReadOnlySpan<char> code) => ScanQuoted(code, '"', 0);
+
+    static int CountDigits(ReadOnlySpan<char> code)
+    {
+        int i = 0;
+        while (i < code.Length && char.IsDigit(code[i])) {
+            ++i;
+        }
+        return i;
+    }
+
+    /// <summary>Scans a quoted literal on a single line, where a backslash escapes the next character.</summary>
+    /// <remarks>
+    /// Mirrors the backtracking of <c>Q((?:\\?.)*?)Q</c>: an escape sequence is only taken if a closing quote can still be reached after it, otherwise the backslash is a character by itself.
+    /// </remarks>
+    static int ScanQuoted(ReadOnlySpan<char> code, char quote, int minCharCount)
+    {
+        if (code.Length == 0 || code[0] != quote) {
+            return 0;
+        }
+        int iEol = code.IndexOf('\n');
+        var line = iEol == -1 ? code : code[..iEol];
+        int firstCandidate = 1 + minCharCount;
+        if (firstCandidate >= line.Length) {
+            return 0;
+        }
+        int iLastQuote = line[firstCandidate..].LastIndexOf(quote);
+        if (iLastQuote == -1) {
+            return 0;
+        }
+        iLastQuote += firstCandidate;
+
+        int i = 1;
+        for (int charCount = 0; charCount < minCharCount || line[i] != quote; ++charCount) {
+            i += line[i] == '\\' && i + 2 <= iLastQuote ? 2 : 1;
+        }
+        return i + 1;
+    }
+}
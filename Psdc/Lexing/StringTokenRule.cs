@@ -2,12 +2,13 @@ namespace Scover.Psdc.Lexing;
 
 sealed class StringTokenRule(TokenType tokenType, string expected, StringComparison comparison) : TokenRule
 {
-    readonly StringComparison _comparison = comparison;
-
+    public StringComparison Comparison { get; } = comparison;
     public TokenType TokenType { get; } = tokenType;
     public string Expected { get; } = expected;
 
-    public ValueOption<Token> Extract(string input, int startIndex) => input.AsSpan()[startIndex..].StartsWith(Expected, _comparison)
-        ? new Token(TokenType, null, new(startIndex, Expected.Length)).Some()
+    public bool CanStartWith(char c) => Expected.AsSpan(0, 1).Equals([c], Comparison);
+
+    public ValueOption<Token> Extract(string input, int startIndex) => input.AsSpan()[startIndex..].StartsWith(Expected, Comparison)
+        ? new Token(TokenType, default, new(startIndex, Expected.Length)).Some()
         : default;
 }
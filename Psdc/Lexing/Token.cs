@@ -1,6 +1,15 @@
 namespace Scover.Psdc.Lexing;
 
-public readonly record struct Token(TokenType Type, string? Value, LengthRange Position)
+/// <summary>
+/// A token.
+/// </summary>
+/// <param name="Type">The type of the token.</param>
+/// <param name="Value">The value of the token, as a slice of the preprocessed code. Empty for tokens that are not <see cref="TokenType.Valued"/>. For identifiers, the interned name.</param>
+/// <param name="Position">The position of the token in the preprocessed code.</param>
+public readonly record struct Token(TokenType Type, ReadOnlyMemory<char> Value, LengthRange Position)
 {
-    public override string ToString() => $"{Type} {(Value is null ? "" : $"`{Value}`")}";
+    /// <summary>For identifiers, the id of the name in the compilation. Tokens of the same name have the same id.</summary>
+    public int NameId { get; init; }
+
+    public override string ToString() => $"{Type} {(Type is TokenType.Valued ? $"`{Value}`" : "")}";
 }
@@ -2,7 +2,10 @@ namespace Scover.Psdc.Lexing;
 
 interface TokenRule
 {
-    TokenType TokenType { get; }
+    /// <summary>Determines whether a token of this rule can start with a character.</summary>
+    /// <param name="c">The first character of the token.</param>
+    /// <returns>Whether extracting a token starting with <paramref name="c"/> can succeed.</returns>
+    bool CanStartWith(char c);
 
     /// <summary>Attempts to extract a token out of a string.</summary>
     /// <param name="input">The input code.</param>
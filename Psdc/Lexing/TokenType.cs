@@ -1,5 +1,4 @@
 using System.Collections.Immutable;
-using System.Text.RegularExpressions;
 
 namespace Scover.Psdc.Lexing;
 
@@ -12,9 +11,28 @@ public class TokenType
 
     protected static IEnumerable<T> GetRules<T>(TokenType self, IEnumerable<Func<TokenType, T>> rules) => rules.Select(r => r(self));
 
+    static readonly List<TokenType> allInstances = [];
+
     readonly string _repr;
 
-    TokenType(string repr, bool isCode) => _repr = isCode ? $"'{repr}'" : repr;
+    TokenType(string repr, bool isCode)
+    {
+        _repr = isCode ? $"'{repr}'" : repr;
+        lock (allInstances) {
+            Id = allInstances.Count;
+            allInstances.Add(this);
+        }
+    }
+
+    /// <summary>Gets the identifier of this token type: a dense index, in order of creation.</summary>
+    internal int Id { get; }
+
+    internal static TokenType FromId(int id)
+    {
+        lock (allInstances) {
+            return allInstances[id];
+        }
+    }
 
     public static TokenType Eof { get; } = new("end of file", false);
 
@@ -207,29 +225,29 @@ public class TokenType
         #endregion Operators
     }
 
-    internal sealed class Valued : TokenType, Ruled<RegexTokenRule>
+    internal sealed class Valued : TokenType, Ruled<ScannerTokenRule>
     {
         static readonly List<Valued> instances = [];
 
-        public IEnumerable<RegexTokenRule> Rules { get; }
+        public IEnumerable<ScannerTokenRule> Rules { get; }
 
-        Valued(string name, string pattern, RegexOptions options = RegexOptions.None) : base(name, false)
+        Valued(string name, Scanner scan, Predicate<char> canStartWith, int prefixLength = 0, int suffixLength = 0) : base(name, false)
         {
             instances.Add(this);
-            Rules = GetRules(this, [t => new RegexTokenRule(t, pattern, options)]);
+            Rules = GetRules(this, [t => new ScannerTokenRule(t, scan, canStartWith, prefixLength, suffixLength)]);
         }
 
         public static IReadOnlyCollection<Valued> Instances => instances;
-        public static Valued CommentMultiline { get; } = new("multiline comment", @"/\*(.*?)\*/", RegexOptions.Singleline);
-        public static Valued CommentSingleline { get; } = new("singleline comment", "//(.*)$", RegexOptions.Multiline);
-        public static Valued Identifier { get; } = new("identifier", @"([\p{L}_][\p{L}_0-9]*)");
-        public static Valued LiteralCharacter { get; } = new("character literal", @"'((?:\\?.)+?)'");
-        public static Valued LiteralInteger { get; } = new("integer literal", @"(\d+)");
-        public static Valued LiteralReal { get; } = new("real literal", @"(\d*\.\d+)");
-        public static Valued LiteralString { get; } = new("string literal", @"""((?:\\?.)*?)""");
-
-        // Matches Identifier's regex second part: [\p{L}_0-9]
-        internal static bool IsIdentifierChar(char c) => c == '_' || char.IsLetterOrDigit(c);
+        public static Valued CommentMultiline { get; } = new("multiline comment", Scanners.CommentMultiline, c => c == '/', prefixLength: 2, suffixLength: 2);
+        public static Valued CommentSingleline { get; } = new("singleline comment", Scanners.CommentSingleline, c => c == '/', prefixLength: 2);
+        public static Valued Identifier { get; } = new("identifier", Scanners.Identifier, c => c == '_' || char.IsLetter(c));
+        public static Valued LiteralCharacter { get; } = new("character literal", Scanners.LiteralCharacter, c => c == '\'', prefixLength: 1, suffixLength: 1);
+        public static Valued LiteralInteger { get; } = new("integer literal", Scanners.LiteralInteger, char.IsDigit);
+        public static Valued LiteralReal { get; } = new("real literal", Scanners.LiteralReal, c => c == '.' || char.IsDigit(c));
+        public static Valued LiteralString { get; } = new("string literal", Scanners.LiteralString, c => c == '"', prefixLength: 1, suffixLength: 1);
+
+        // Matches the characters that can follow the first one in an identifier: [\p{L}_0-9]
+        internal static bool IsIdentifierChar(char c) => c == '_' || char.IsLetter(c) || char.IsAsciiDigit(c);
     }
 
     internal sealed class ContextKeyword
@@ -237,6 +255,16 @@ public class TokenType
         public IImmutableSet<string> Names { get; }
         ContextKeyword(IImmutableSet<string> names) => Names = names;
 
+        public bool IsMatch(ReadOnlySpan<char> identifier)
+        {
+            foreach (var name in Names) {
+                if (identifier.SequenceEqual(name)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
         public static ContextKeyword Assert { get; } = new(["assert"]);
         public static ContextKeyword Eval { get; } = new(["eval"]);
         public static ContextKeyword Expr { get; } = new(["expr"]);
@@ -0,0 +1,74 @@
+using System.Collections;
+using System.Diagnostics.CodeAnalysis;
+
+namespace Scover.Psdc.Lexing;
+
+/// <summary>
+/// An immutable map from token types to values, stored as the <see cref="TokenTypeSet"/> of its keys and an array of its values.
+/// </summary>
+/// <typeparam name="T">The type of the values.</typeparam>
+/// <remarks>
+/// <para>Looking up a token type is a bit test and a population count on the identifier of the token type: there is no hashing.</para>
+/// <para>Build it with an object initializer, such as <c>new() { [Keyword.If] = ... }</c>. Values are stored in the order of the identifiers of their keys.</para>
+/// </remarks>
+public readonly struct TokenTypeMap<T> : IEnumerable<KeyValuePair<TokenType, T>>
+{
+    readonly TokenTypeSet _keys;
+    readonly T[]? _values;
+
+    public TokenTypeMap(IEnumerable<KeyValuePair<TokenType, T>> items)
+    {
+        foreach (var (key, value) in items) {
+            Add(ref _keys, ref _values, key, value);
+        }
+    }
+
+    public TokenTypeSet Keys => _keys;
+
+    public int Count => _keys.Count;
+
+    /// <summary>Gets the value of a token type.</summary>
+    /// <exception cref="KeyNotFoundException"><paramref name="key"/> isn't in this map.</exception>
+    public T this[TokenType key]
+    {
+        get => TryGetValue(key, out var value) ? value : throw new KeyNotFoundException($"{key} isn't in the map");
+        init => Add(ref _keys, ref _values, key, value);
+    }
+
+    public bool TryGetValue(TokenType key, [MaybeNullWhen(false)] out T value)
+    {
+        if (_keys.Contains(key)) {
+            value = _values![_keys.Rank(key)];
+            return true;
+        }
+        value = default;
+        return false;
+    }
+
+    public IEnumerator<KeyValuePair<TokenType, T>> GetEnumerator()
+    {
+        int i = 0;
+        foreach (var key in _keys) {
+            yield return new(key, _values![i++]);
+        }
+    }
+
+    IEnumerator IEnumerable.GetEnumerator() => GetEnumerator();
+
+    // Only called while building the map.
+    static void Add(ref TokenTypeSet keys, ref T[]? values, TokenType key, T value)
+    {
+        int rank = keys.Rank(key);
+        if (keys.Contains(key)) {
+            values![rank] = value;
+            return;
+        }
+        var newValues = new T[keys.Count + 1];
+        if (values is not null) {
+            Array.Copy(values, newValues, rank);
+            Array.Copy(values, rank, newValues, rank + 1, values.Length - rank);
+        }
+        newValues[rank] = value;
+        (keys, values) = (keys.Union(TokenTypeSet.Of(key)), newValues);
+    }
+}
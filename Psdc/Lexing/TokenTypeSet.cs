@@ -0,0 +1,82 @@
+using System.Collections;
+using System.Numerics;
+
+namespace Scover.Psdc.Lexing;
+
+/// <summary>
+/// An immutable set of token types, stored as a bitset of their identifiers.
+/// </summary>
+/// <remarks>Creating, combining and testing sets doesn't allocate. Enumeration yields token types in the order of their identifiers.</remarks>
+public readonly struct TokenTypeSet : IEquatable<TokenTypeSet>, IEnumerable<TokenType>
+{
+    const int Capacity = 2 * 64;
+
+    readonly ulong _low, _high;
+
+    TokenTypeSet(ulong low, ulong high) => (_low, _high) = (low, high);
+
+    public static TokenTypeSet Empty => default;
+
+    public int Count => BitOperations.PopCount(_low) + BitOperations.PopCount(_high);
+
+    public bool IsEmpty => (_low | _high) == 0;
+
+    internal static TokenTypeSet Of(TokenType type)
+    {
+        int id = type.Id;
+        if (id >= Capacity) {
+            throw new InvalidOperationException($"{nameof(TokenTypeSet)} can't hold more than {Capacity} token types");
+        }
+        return id < 64 ? new(1UL << id, 0) : new(0, 1UL << (id - 64));
+    }
+
+    internal static TokenTypeSet Of(params TokenType[] types) => Of((IEnumerable<TokenType>)types);
+
+    internal static TokenTypeSet Of(IEnumerable<TokenType> types)
+    {
+        TokenTypeSet set = default;
+        foreach (var type in types) {
+            set = set.Union(Of(type));
+        }
+        return set;
+    }
+
+    public bool Contains(TokenType type)
+    {
+        int id = type.Id;
+        return id < 64 ? (_low & 1UL << id) != 0 : id < Capacity && (_high & 1UL << (id - 64)) != 0;
+    }
+
+    /// <summary>Gets the number of token types in this set whose identifier is lower than that of <paramref name="type"/>.</summary>
+    internal int Rank(TokenType type)
+    {
+        int id = type.Id;
+        return id < 64
+            ? BitOperations.PopCount(_low & ((1UL << id) - 1))
+            : BitOperations.PopCount(_low) + BitOperations.PopCount(_high & ((1UL << (id - 64)) - 1));
+    }
+
+    public TokenTypeSet Union(TokenTypeSet other) => new(_low | other._low, _high | other._high);
+
+    public bool Equals(TokenTypeSet other) => _low == other._low && _high == other._high;
+
+    public override bool Equals(object? obj) => obj is TokenTypeSet other && Equals(other);
+
+    public override int GetHashCode() => HashCode.Combine(_low, _high);
+
+    public static bool operator ==(TokenTypeSet left, TokenTypeSet right) => left.Equals(right);
+
+    public static bool operator !=(TokenTypeSet left, TokenTypeSet right) => !left.Equals(right);
+
+    public IEnumerator<TokenType> GetEnumerator()
+    {
+        for (var bits = _low; bits != 0; bits &= bits - 1) {
+            yield return TokenType.FromId(BitOperations.TrailingZeroCount(bits));
+        }
+        for (var bits = _high; bits != 0; bits &= bits - 1) {
+            yield return TokenType.FromId(64 + BitOperations.TrailingZeroCount(bits));
+        }
+    }
+
+    IEnumerator IEnumerable.GetEnumerator() => GetEnumerator();
+}
@@ -0,0 +1,76 @@
+namespace Scover.Psdc.Lexing;
+
+/// <summary>
+/// Matches the longest of a set of fixed-text tokens by walking a prefix tree, in time proportional to the length of the token rather than to the number of rules.
+/// </summary>
+sealed class TrieTokenRule : TokenRule
+{
+    readonly Node _root = new();
+    readonly bool _isWord;
+
+    /// <summary>Creates a trie of punctuation rules, that match regardless of what follows them.</summary>
+    public TrieTokenRule(IEnumerable<StringTokenRule> rules) : this(false)
+    {
+        foreach (var rule in rules) {
+            Add(rule.TokenType, rule.Expected, rule.Comparison);
+        }
+    }
+
+    /// <summary>Creates a trie of word rules, that must not be followed by an identifier character.</summary>
+    public TrieTokenRule(IEnumerable<WordTokenRule> rules) : this(true)
+    {
+        foreach (var rule in rules) {
+            Add(rule.TokenType, rule.Expected, rule.Comparison);
+        }
+    }
+
+    TrieTokenRule(bool isWord) => _isWord = isWord;
+
+    public bool CanStartWith(char c) => _root.Children.ContainsKey(c);
+
+    public ValueOption<Token> Extract(string input, int startIndex)
+    {
+        ValueOption<Token> longest = default;
+        var node = _root;
+        for (int i = startIndex; i < input.Length && node.Children.TryGetValue(input[i], out node); ++i) {
+            int indexAfter = i + 1;
+            if (node.TokenType is { } type
+             && (!_isWord || indexAfter == input.Length || !TokenType.Valued.IsIdentifierChar(input[indexAfter]))) {
+                longest = new Token(type, default, new(startIndex, indexAfter - startIndex)).Some();
+            }
+        }
+        return longest;
+    }
+
+    void Add(TokenType type, string text, StringComparison comparison)
+    {
+        IReadOnlyList<Node> nodes = [_root];
+        foreach (var c in text) {
+            var variants = GetVariants(c, comparison);
+            nodes = nodes.SelectMany(n => variants.Select(n.GetOrAddChild)).ToArray();
+        }
+        foreach (var node in nodes) {
+            node.TokenType = type;
+        }
+    }
+
+    static IReadOnlyList<char> GetVariants(char c, StringComparison comparison) => comparison switch {
+        StringComparison.Ordinal => [c],
+        StringComparison.OrdinalIgnoreCase => new[] { char.ToLowerInvariant(c), char.ToUpperInvariant(c) }.Distinct().ToArray(),
+        _ => throw comparison.ToUnmatchedException(),
+    };
+
+    sealed class Node
+    {
+        public Dictionary<char, Node> Children { get; } = [];
+        public TokenType? TokenType { get; set; }
+
+        public Node GetOrAddChild(char c)
+        {
+            if (!Children.TryGetValue(c, out var child)) {
+                Children.Add(c, child = new());
+            }
+            return child;
+        }
+    }
+}
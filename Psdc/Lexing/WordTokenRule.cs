@@ -4,9 +4,12 @@ sealed class WordTokenRule(TokenType tokenType, string word, StringComparison co
 {
     readonly StringTokenRule _stringRule = new(tokenType, word, comparison);
 
+    public StringComparison Comparison => _stringRule.Comparison;
     public string Expected => _stringRule.Expected;
     public TokenType TokenType { get; } = tokenType;
 
+    public bool CanStartWith(char c) => _stringRule.CanStartWith(c);
+
     public ValueOption<Token> Extract(string code, int startIndex)
     {
         int indexAfter = startIndex + Expected.Length;
@@ -1,4 +1,3 @@
-using System.Collections.Immutable;
 using System.Diagnostics;
 using System.Diagnostics.CodeAnalysis;
 using System.Globalization;
@@ -97,33 +96,6 @@ public static class Extensions
         return count;
     }
 
-    internal static ReadOnlySpan<char> GetLine(this string str, int lineNumber)
-    {
-        var lines = str.AsSpan().EnumerateLines();
-        bool success = true;
-        for (; success && lineNumber >= 0; --lineNumber) {
-            success = lines.MoveNext();
-        }
-        return success
-            ? lines.Current
-            : throw new ArgumentOutOfRangeException(nameof(lineNumber), "Line number is out of range");
-    }
-
-    internal static Position GetPositionAt(this string str, Index index)
-    {
-        int line = 0, column = 0;
-        for (int i = 0; i < index.Value; i++) {
-            if (str.AsSpan().Slice(i, Environment.NewLine.Length).SequenceEqual(Environment.NewLine)) {
-                line++;
-                column = 0;
-                i += Environment.NewLine.Length - 1; // Skip the rest of the newline sequence
-            } else {
-                column++;
-            }
-        }
-        return new Position(line, column);
-    }
-
     /// <summary>
     /// Checks if an exception is exogenous and could have been thrown by the filesystem API.
     /// </summary>
@@ -150,6 +122,12 @@ public static class Extensions
         return t;
     }
 
+    internal static void LogOperation(this string name, bool verbose, Action operation) =>
+        name.LogOperation(verbose, () => {
+            operation();
+            return true;
+        });
+
     /// <summary>Asserts that <paramref name="t" /> isn't <see langword="null" />.</summary>
     /// <remarks>This is a safer replacement for the null-forgiving operator (<c>!</c>).</remarks>
     /// <returns><paramref name="t" />, not null.</returns>
@@ -195,7 +173,7 @@ public static class Extensions
 
     public static string ToQuantity(this int amount, string singular) => amount.ToQuantity(singular, singular + "s");
 
-    public static (Position Start, Position End) Apply(this Range range, string str) => (str.GetPositionAt(range.Start), str.GetPositionAt(range.End));
+    public static (Position Start, Position End) Apply(this Range range, LineMap lines) => (lines.GetPositionAt(range.Start), lines.GetPositionAt(range.End));
 
     public static bool IsEmpty(this Range range) => range.Start.Equals(range.End);
 }
@@ -213,7 +191,3 @@ static class Function
         }
     };
 }
-static class Set
-{
-    internal static ImmutableHashSet<T> Of<T>(params T[] items) => [.. items];
-}
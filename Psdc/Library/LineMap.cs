@@ -0,0 +1,55 @@
+namespace Scover.Psdc.Library;
+
+/// <summary>
+/// An index of the lines of a text, for converting offsets to <see cref="Position"/>s in logarithmic time.
+/// </summary>
+/// <remarks>Lines are terminated by <c>\n</c> or <c>\r\n</c>, regardless of <see cref="Environment.NewLine"/>.</remarks>
+public sealed class LineMap
+{
+    readonly int[] _lineStarts;
+
+    public LineMap(string text)
+    {
+        Text = text;
+        List<int> lineStarts = [0];
+        var span = text.AsSpan();
+        for (int i = span.IndexOf('\n'); i != -1;) {
+            lineStarts.Add(++i);
+            int iNext = span[i..].IndexOf('\n');
+            i = iNext == -1 ? -1 : i + iNext;
+        }
+        _lineStarts = lineStarts.ToArray();
+    }
+
+    /// <summary>Gets the text this map indexes.</summary>
+    public string Text { get; }
+
+    /// <summary>Gets the content of a line, without its terminator.</summary>
+    /// <param name="lineNumber">The 0-based line number.</param>
+    public ReadOnlySpan<char> GetLine(int lineNumber)
+    {
+        if (lineNumber < 0 || lineNumber >= _lineStarts.Length) {
+            throw new ArgumentOutOfRangeException(nameof(lineNumber), "Line number is out of range");
+        }
+        int start = _lineStarts[lineNumber];
+        if (lineNumber + 1 == _lineStarts.Length) {
+            return Text.AsSpan(start);
+        }
+        int end = _lineStarts[lineNumber + 1] - 1;
+        if (end > start && Text[end - 1] == '\r') {
+            --end;
+        }
+        return Text.AsSpan(start, end - start);
+    }
+
+    /// <summary>Gets the position of an offset in the text.</summary>
+    public Position GetPositionAt(Index index)
+    {
+        int offset = index.GetOffset(Text.Length);
+        int line = Array.BinarySearch(_lineStarts, offset);
+        if (line < 0) {
+            line = ~line - 1;
+        }
+        return new(line, offset - _lineStarts[line]);
+    }
+}
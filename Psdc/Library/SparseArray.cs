@@ -0,0 +1,72 @@
+using System.Collections;
+
+namespace Scover.Psdc.Library;
+
+/// <summary>
+/// An immutable list of a fixed length, whose items are a default item except for a few that are set.
+/// </summary>
+/// <typeparam name="T">The item type.</typeparam>
+/// <remarks>Only the set items are stored, so memory scales with their number rather than with the length.</remarks>
+sealed class SparseArray<T> : IReadOnlyList<T>
+{
+    // Sorted indexes of the set items, and the items at these indexes.
+    readonly int[] _indexes;
+    readonly T[] _items;
+
+    public SparseArray(int length, T defaultItem) : this(length, defaultItem, [], []) { }
+
+    SparseArray(int length, T defaultItem, int[] indexes, T[] items)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegative(length);
+        (Count, DefaultItem, _indexes, _items) = (length, defaultItem, indexes, items);
+    }
+
+    /// <summary>Creates a sparse array from its set items.</summary>
+    /// <param name="length">The length of the array.</param>
+    /// <param name="defaultItem">The item at the indexes that aren't set.</param>
+    /// <param name="setItems">The set items, by index, in any order. Indexes must be distinct.</param>
+    public static SparseArray<T> Create(int length, T defaultItem, IEnumerable<KeyValuePair<int, T>> setItems)
+    {
+        var items = setItems.ToArray();
+        int[] indexes = new int[items.Length];
+        T[] values = new T[items.Length];
+        for (int i = 0; i < items.Length; ++i) {
+            ArgumentOutOfRangeException.ThrowIfNegative(items[i].Key);
+            ArgumentOutOfRangeException.ThrowIfGreaterThanOrEqual(items[i].Key, length);
+            (indexes[i], values[i]) = (items[i].Key, items[i].Value);
+        }
+        Array.Sort(indexes, values);
+        return new(length, defaultItem, indexes, values);
+    }
+
+    public int Count { get; }
+
+    public T DefaultItem { get; }
+
+    /// <summary>Gets the set items, by increasing index.</summary>
+    public IEnumerable<KeyValuePair<int, T>> SetItems => _indexes.Zip(_items, KeyValuePair.Create);
+
+    public T this[int index]
+    {
+        get {
+            ArgumentOutOfRangeException.ThrowIfNegative(index);
+            ArgumentOutOfRangeException.ThrowIfGreaterThanOrEqual(index, Count);
+            int i = Array.BinarySearch(_indexes, index);
+            return i >= 0 ? _items[i] : DefaultItem;
+        }
+    }
+
+    public IEnumerator<T> GetEnumerator()
+    {
+        int next = 0;
+        for (int index = 0; index < Count; ++index) {
+            if (next < _indexes.Length && _indexes[next] == index) {
+                yield return _items[next++];
+            } else {
+                yield return DefaultItem;
+            }
+        }
+    }
+
+    IEnumerator IEnumerable.GetEnumerator() => GetEnumerator();
+}
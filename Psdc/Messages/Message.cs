@@ -52,6 +52,9 @@ public readonly struct Message
     internal static Message ErrorSwitchDefaultIsNotLast(Range location) => new(location, MessageCode.SwitchDefaultIsNotLast,
         "default not last in switch; all cases below are unreachable",
         ["move the default case to the end of the switch statement"]);
+    internal static Message ErrorNestingTooDeep(Range location, int maxNestingDepth) => new(location, MessageCode.NestingTooDeep,
+        "nesting too deep",
+        [Fmt($"the maximum nesting depth of expressions, statements, types and initializers is {maxNestingDepth}")]);
     internal static Message ErrorIndexOutOfBounds(ComptimeExpression<int> index, int length) =>
         ErrorIndexOutOfBounds(index.Expression.Meta.Location, index.Value, length);
     internal static Message ErrorFeatureComingSoon(Range location, string feature) => new(location, MessageCode.FeatureNotAvailable,
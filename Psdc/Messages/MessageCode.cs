@@ -34,6 +34,7 @@ public enum MessageCode
     FeatureNotAvailable,
     ReturnExpectsValue,
     SwitchDefaultIsNotLast,
+    NestingTooDeep,
     CustomError = 999,
 
     #endregion Errors
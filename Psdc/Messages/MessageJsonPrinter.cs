@@ -3,10 +3,10 @@ using System.Text.Json;
 
 namespace Scover.Psdc.Messages;
 
-public sealed class MessageJsonPrinter(TextWriter output, string input) : MessagePrinter
+public sealed class MessageJsonPrinter(TextWriter output, LineMap lines) : MessagePrinter
 {
     readonly TextWriter _output = output;
-    readonly string _input = input;
+    readonly LineMap _lines = lines;
 
     public void Conclude(Func<MessageSeverity, int> msgCount) { }
 
@@ -27,9 +27,9 @@ public sealed class MessageJsonPrinter(TextWriter output, string input) : Messag
 
     void PrintMessage(Message msg)
     {
-        var (start, end) = msg.Location.Apply(_input);
+        var (start, end) = msg.Location.Apply(_lines);
         _output.Write(string.Create(CultureInfo.InvariantCulture,
-            @$"{{""code"":{msg.Code:d},""content"":""{JsonStr(msg.Content.Get(_input))}"",""start"":{FormatPosition(start)},""end"":{FormatPosition(end)},""severity"":{(int)msg.Severity},""advice"":["));
+            @$"{{""code"":{msg.Code:d},""content"":""{JsonStr(msg.Content.Get(_lines.Text))}"",""start"":{FormatPosition(start)},""end"":{FormatPosition(end)},""severity"":{(int)msg.Severity},""advice"":["));
         bool notFirst = false;
         foreach (var adv in msg.AdvicePieces) {
             if (notFirst) {
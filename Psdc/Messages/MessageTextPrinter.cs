@@ -3,7 +3,7 @@ namespace Scover.Psdc.Messages;
 public sealed class MessageTextPrinter(
     TextWriter output,
     string sourceFile,
-    string input,
+    LineMap lines,
     MessageTextPrinter.Style style
 ) : MessagePrinter
 {
@@ -15,7 +15,7 @@ public sealed class MessageTextPrinter(
 
     readonly TextWriter _output = output;
     readonly string _sourceFile = sourceFile;
-    readonly string _input = input;
+    readonly LineMap _lines = lines;
     readonly Style _style = style;
     const string LineNoMargin = "    ";
     const string Bar = " | ";
@@ -46,7 +46,7 @@ public sealed class MessageTextPrinter(
 
     void PrintMessage(Message message)
     {
-        var (start, end) = message.Location.Apply(_input);
+        var (start, end) = message.Location.Apply(_lines);
         var msgColor = ConsoleColors.ForMessageSeverity(message.Severity);
         var lineNoPadding = (end.Line + 1).DigitCount();
 
@@ -58,7 +58,7 @@ public sealed class MessageTextPrinter(
 
         // If the error spans over only 1 line, show it with carets underneath
         if (start.Line == end.Line) {
-            ReadOnlySpan<char> badLine = _input.GetLine(end.Line);
+            ReadOnlySpan<char> badLine = _lines.GetLine(end.Line);
 
             // Bad line
             StartLine(lineNoPadding, end.Line);
@@ -83,7 +83,7 @@ public sealed class MessageTextPrinter(
         else {
             StartLine(lineNoPadding, start.Line);
             {
-                ReadOnlySpan<char> badLine = _input.GetLine(start.Line);
+                ReadOnlySpan<char> badLine = _lines.GetLine(start.Line);
                 _output.Write(badLine[..start.Column]);
                 msgColor.SetColor();
                 EndLine(badLine[start.Column..]);
@@ -94,7 +94,7 @@ public sealed class MessageTextPrinter(
             var badLines = Enumerable.Range(start.Line + 1, badLineCount).ToArray();
             const int MaxBadLines = MaxMultilineErrorLines - 2;
             foreach (var line in badLines.Take(MaxBadLines)) {
-                ReadOnlySpan<char> badLine = _input.GetLine(line);
+                ReadOnlySpan<char> badLine = _lines.GetLine(line);
                 StartLine(lineNoPadding, line);
                 msgColor.SetColor();
                 EndLine(badLine);
@@ -110,7 +110,7 @@ public sealed class MessageTextPrinter(
 
             StartLine(lineNoPadding, end.Line);
             {
-                ReadOnlySpan<char> badLine = _input.GetLine(end.Line);
+                ReadOnlySpan<char> badLine = _lines.GetLine(end.Line);
                 msgColor.SetColor();
                 _output.Write(badLine[..end.Column]);
                 Console.ResetColor();
@@ -129,7 +129,7 @@ public sealed class MessageTextPrinter(
 
     void PrintLocationGnu(Message msg)
     {
-        var (start, end) = msg.Location.Apply(_input);
+        var (start, end) = msg.Location.Apply(_lines);
 
         _output.Write(
             start.Line == end.Line
@@ -140,17 +140,17 @@ public sealed class MessageTextPrinter(
         msgColor.DoInColor(() => _output.Write(
             string.Create(Format.Msg, $"P{(int)msg.Code:d4}: {msg.Severity.ToString().ToLower(Format.Msg)}:")));
 
-        _output.WriteLine($" {msg.Content.Get(_input)}");
+        _output.WriteLine($" {msg.Content.Get(_lines.Text)}");
     }
 
     void PrintLocationVsCode(Message msg)
     {
-        var (start, _) = msg.Location.Apply(_input);
+        var (start, _) = msg.Location.Apply(_lines);
 
         var msgColor = ConsoleColors.ForMessageSeverity(msg.Severity);
         msgColor.DoInColor(() => _output.Write(string.Create(Format.Msg, $"[P{(int)msg.Code:d4}] ")));
 
-        _output.WriteLine(string.Create(Format.Msg, $"{start}: {msg.Severity.ToString().ToLower(Format.Msg)}: {msg.Content.Get(_input)}"));
+        _output.WriteLine(string.Create(Format.Msg, $"{start}: {msg.Severity.ToString().ToLower(Format.Msg)}: {msg.Content.Get(_lines.Text)}"));
     }
 
     void EndLine(ReadOnlySpan<char> content) => _output.WriteLine(content.TrimEnd());
@@ -1,25 +1,35 @@
 using System.Diagnostics;
+using System.Runtime.InteropServices;
+
+using Scover.Psdc.Lexing;
 
 namespace Scover.Psdc.Parsing;
 
 public sealed class Ident : Node, IEquatable<Ident?>
 {
-    public Ident(Range location, string name)
+    readonly ReadOnlyMemory<char> _name;
+    string? _nameString;
+
+    /// <summary>Creates an identifier from an identifier token.</summary>
+    public Ident(Range location, Token token)
     {
-        Debug.Assert(
-            name.Length > 0
-         && (name[0] == '_' || char.IsLetter(name[0]))
-         && name.Skip(1).All(c => c == '_' || char.IsLetterOrDigit(c)),
-            $"`{name}` is not a valid identifier");
-        (Location, Name) = (location, name);
+        Debug.Assert(token.Type == TokenType.Valued.Identifier, $"{token} is not an identifier");
+        (Location, _name, Id) = (location, token.Value, token.NameId);
     }
 
     public Range Location { get; }
-    public string Name { get; }
 
-    // Equals and GetHashCode implementation for usage in dictionaries.
+    /// <summary>Gets the id of the name in the compilation. Identifiers of the same name have the same id.</summary>
+    public int Id { get; }
+
+    // The lexer interns names, so the memory usually wraps the whole name string.
+    public string Name => _nameString ??= MemoryMarshal.TryGetString(_name, out var name, out _, out int length) && length == name.Length
+        ? name
+        : _name.ToString();
+
+    // Equals and GetHashCode implementation for usage in dictionaries. Only identifiers of the same compilation can be compared.
     public override bool Equals(object? obj) => Equals(obj as Ident);
-    public bool Equals(Ident? other) => other is not null && other.Name == Name;
-    public override int GetHashCode() => Name.GetHashCode();
+    public bool Equals(Ident? other) => other is not null && other.Id == Id;
+    public override int GetHashCode() => Id;
     public override string ToString() => Name;
 }
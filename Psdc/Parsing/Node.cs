@@ -140,12 +140,12 @@ public interface Node
 
             internal sealed record Integer(Range Location, int Value) : Literal<IntegerType, IntegerValue, int>(Location, IntegerType.Instance, Value)
             {
-                public Integer(Range location, string valueStr) : this(location, int.Parse(valueStr, Format.Code)) { }
+                public Integer(Range location, ReadOnlySpan<char> valueStr) : this(location, int.Parse(valueStr, Format.Code)) { }
             }
 
             internal sealed record Real(Range Location, decimal Value) : Literal<RealType, RealValue, decimal>(Location, RealType.Instance, Value)
             {
-                public Real(Range location, string valueStr) : this(location, decimal.Parse(valueStr, Format.Code)) { }
+                public Real(Range location, ReadOnlySpan<char> valueStr) : this(location, decimal.Parse(valueStr, Format.Code)) { }
             }
 
             internal sealed record String(Range Location, string Value)
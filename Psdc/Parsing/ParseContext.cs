@@ -0,0 +1,88 @@
+using Scover.Psdc.Lexing;
+using Scover.Psdc.Messages;
+
+namespace Scover.Psdc.Parsing;
+
+/// <summary>
+/// The state of a single parse: the tokens being parsed, where to report errors, and the packrat memo tables.
+/// </summary>
+/// <remarks>The grammar itself is shared between parses; everything that changes while parsing lives here.</remarks>
+sealed class ParseContext
+{
+    // The errors of the failed results of the parse running on this thread. Results aren't read after their parse, so the list is reused by the next one.
+    [ThreadStatic] static List<ParseError>? errors;
+
+    // Memo tables of memoized productions, indexed by production id.
+    readonly object?[] _memoTables;
+    readonly List<ParseError> _errors;
+    readonly bool _memoize;
+    readonly int _maxNestingDepth;
+    int _nestingDepth;
+
+    public ParseContext(Token[] tokens, Messenger messenger, bool memoize, int memoizedProductionCount, int maxNestingDepth)
+    {
+        Tokens = tokens;
+        Messenger = messenger;
+        _memoTables = new object?[memoizedProductionCount];
+        _memoize = memoize;
+        _maxNestingDepth = maxNestingDepth;
+        _errors = errors ??= [];
+    }
+
+    public Token[] Tokens { get; }
+    public Messenger Messenger { get; }
+
+    /// <summary>Gets the operands of the expressions being parsed, with the offset of their first token from the start of their expression.</summary>
+    /// <remarks>Shared by the expressions nested in operands, which leave it as they found it.</remarks>
+    public Stack<(int Offset, Node.Expr Expr)> Operands { get; } = new();
+
+    /// <summary>Gets the operators and opening parentheses of the expressions being parsed that wait for their operands.</summary>
+    /// <remarks>Shared by the expressions nested in operands, which leave it as they found it.</remarks>
+    public Stack<Parser.PendingOperator> Operators { get; } = new();
+
+    /// <summary>Gets whether the maximum nesting depth has been exceeded. The rest of the parse is then abandoned.</summary>
+    public bool NestingLimitExceeded { get; private set; }
+
+    /// <summary>Enters a nested construct, such as an expression, a statement or a type.</summary>
+    /// <param name="tokens">The start of the construct.</param>
+    /// <returns>Whether the construct can be parsed. When it is nested too deeply, the error is reported once and all following constructs fail.</returns>
+    /// <remarks>Call <see cref="ExitNesting"/> after parsing the construct.</remarks>
+    public bool TryEnterNesting(TokenCursor tokens)
+    {
+        if (NestingLimitExceeded) {
+            return false;
+        }
+        if (_nestingDepth == _maxNestingDepth) {
+            NestingLimitExceeded = true;
+            Messenger.Report(Message.ErrorNestingTooDeep(new SourceTokens(tokens, 1).Location, _maxNestingDepth));
+            return false;
+        }
+        ++_nestingDepth;
+        return true;
+    }
+
+    /// <summary>Exits nested constructs entered with <see cref="TryEnterNesting"/>.</summary>
+    /// <param name="levels">The number of constructs to exit.</param>
+    public void ExitNesting(int levels = 1) => _nestingDepth -= levels;
+
+    /// <summary>Adds the error of a failed result.</summary>
+    /// <returns>The index of the error, to get it with <see cref="GetError"/>.</returns>
+    public int AddError(ParseError error)
+    {
+        _errors.Add(error);
+        return _errors.Count - 1;
+    }
+
+    public ParseError GetError(int index) => _errors[index];
+
+    /// <summary>Ends the parse, releasing its errors for the next parse of this thread. The results of this parse mustn't be read afterwards.</summary>
+    public void End() => _errors.Clear();
+
+    /// <summary>Gets the memo table of a production: its results, by token index.</summary>
+    /// <param name="production">The id of the production.</param>
+    /// <param name="always">Whether the production is memoized even when this parse doesn't memoize.</param>
+    /// <returns>The memo table of <paramref name="production"/>, or <see langword="null"/> if it isn't memoized in this parse.</returns>
+    public Dictionary<int, ParseResult<T>>? GetMemoTable<T>(int production, bool always) => _memoize || always
+        ? (Dictionary<int, ParseResult<T>>)(_memoTables[production] ??= new Dictionary<int, ParseResult<T>>())
+        : null;
+}
@@ -4,32 +4,35 @@ using Scover.Psdc.Lexing;
 
 namespace Scover.Psdc.Parsing;
 
-public sealed record ParseError(
+/// <summary>
+/// A syntax error: the production that failed, on which token, and what was expected instead.
+/// </summary>
+/// <remarks>This is a value type, so that failing alternatives, which parsing tries all the time, don't allocate errors.</remarks>
+public readonly record struct ParseError(
     string FailedProduction,
-    Option<Token> ErroneousToken,
-    IImmutableSet<TokenType> ExpectedTokens,
+    ValueOption<Token> ErroneousToken,
+    TokenTypeSet ExpectedTokens,
     IImmutableSet<string> ExpectedProductions
 )
 {
     internal static ParseError ForProduction(
         string failedProduction,
-        Option<Token> erroneousToken,
-        IImmutableSet<TokenType> expectedTokens,
+        ValueOption<Token> erroneousToken,
+        TokenTypeSet expectedTokens,
         string expectedProduction
     ) => new(failedProduction, erroneousToken, expectedTokens, ImmutableHashSet.Create(expectedProduction));
 
-    internal static ParseError ForProduction(string failedProduction, Option<Token> erroneousToken, IImmutableSet<TokenType> expectedTokens) =>
+    internal static ParseError ForProduction(string failedProduction, ValueOption<Token> erroneousToken, TokenTypeSet expectedTokens) =>
         new(failedProduction, erroneousToken, expectedTokens, ImmutableHashSet<string>.Empty);
 
-    internal static ParseError ForProduction(string failedProduction, Option<Token> erroneousToken, TokenType expectedToken) => new(failedProduction,
-        erroneousToken, ImmutableHashSet.Create(expectedToken), ImmutableHashSet<string>.Empty);
+    internal static ParseError ForProduction(string failedProduction, ValueOption<Token> erroneousToken, TokenType expectedToken) => new(failedProduction,
+        erroneousToken, TokenTypeSet.Of(expectedToken), ImmutableHashSet<string>.Empty);
 
-    internal static ParseError ForContextKeyword(string failedProduction, Option<Token> erroneousToken, IImmutableSet<string> identifierValues) =>
-        new(failedProduction, erroneousToken, ImmutableHashSet.Create<TokenType>(TokenType.Valued.Identifier), identifierValues);
+    internal static ParseError ForContextKeyword(string failedProduction, ValueOption<Token> erroneousToken, IImmutableSet<string> identifierValues) =>
+        new(failedProduction, erroneousToken, TokenTypeSet.Of(TokenType.Valued.Identifier), identifierValues);
 
-    internal bool IsEquivalent(ParseError? other) => other is not null
-                                                  && other.ErroneousToken.Equals(ErroneousToken)
-                                                  && other.ExpectedTokens.SetEquals(ExpectedTokens);
+    internal bool IsEquivalent(ParseError other) => other.ErroneousToken.Equals(ErroneousToken)
+                                                 && other.ExpectedTokens == ExpectedTokens;
 
     internal ParseError CombineWith(ParseError other) => ErroneousToken.HasValue && other.ErroneousToken.HasValue
         ? ErroneousToken.Value.Position.Start > other.ErroneousToken.Value.Position.Start ? this
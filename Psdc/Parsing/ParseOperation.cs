@@ -1,11 +1,7 @@
-using System.Collections.Immutable;
-
 using Scover.Psdc.Lexing;
 
 namespace Scover.Psdc.Parsing;
 
-using TokenTypeSet = IImmutableSet<TokenType>;
-
 /// <summary>
 /// A branch in a parsing operation to parse a specific type of node.
 /// </summary>
@@ -19,14 +15,7 @@ delegate (ParseOperation, ResultCreator<T>) Branch<T>(ParseOperation operation);
 /// <typeparam name="T">The type of node parsed.</typeparam>
 /// <param name="tokens">The input tokens.</param>
 /// <returns>A result that encapsulates <typeparamref name="T"/>.</returns>
-delegate ParseResult<T> Parser<out T>(IEnumerable<Token> tokens);
-/// <summary>
-/// A parsing block.
-/// </summary>
-/// <typeparam name="T">The type of node parsed.</typeparam>
-/// <param name="operation">The enclosing parsing operation.</param>
-/// <returns>A result that encapsulates <typeparamref name="T"/>.</returns>
-delegate ParseResult<T> ParseBlock<out T>(ParseOperation operation);
+delegate ParseResult<T> Parser<T>(TokenCursor tokens);
 /// <summary>
 /// A function that creates a node from source tokens.
 /// </summary>
@@ -34,34 +23,66 @@ delegate ParseResult<T> ParseBlock<out T>(ParseOperation operation);
 /// <param name="location">The location of the node.</param>
 /// <returns>The resulting node.</returns>
 delegate T ResultCreator<out T>(Range location);
-delegate T ValuedResultCreator<out T>(Range location, string value);
+/// <summary>
+/// A function that creates a node from source tokens and the values parsed to build it.
+/// </summary>
+/// <typeparam name="TState">The type of the parsed values.</typeparam>
+/// <typeparam name="T">The type of the node to create.</typeparam>
+/// <param name="location">The location of the node.</param>
+/// <param name="state">The parsed values.</param>
+/// <returns>The resulting node.</returns>
+/// <remarks>Passing the parsed values as state lets the creator be a static lambda, so that operations don't allocate a closure for it.</remarks>
+delegate T ResultCreator<in TState, out T>(Range location, TState state);
+delegate T ValuedResultCreator<out T>(Range location, ReadOnlyMemory<char> value);
 /// <summary>
 /// A fluent class to parse production rules.
 /// </summary>
-abstract class ParseOperation
+/// <remarks>
+/// Operations are pooled per thread: an operation is returned to the pool by <see cref="MapResult{T}"/> and must not be used afterwards.
+/// A failed operation doesn't read any more tokens and its methods do nothing until <see cref="MapResult{T}"/> retrieves the error.
+/// </remarks>
+sealed class ParseOperation
 {
-    readonly IEnumerable<Token> _tokens;
+    [ThreadStatic] static Stack<ParseOperation>? pool;
+
+    TokenCursor _tokens;
+    string _prod = "";
     int _readCount;
+    ParseError? _error;
 
-    ParseOperation(IEnumerable<Token> tokens, int readCount) => (_tokens, _readCount) = (tokens, readCount);
+    ParseOperation() { }
 
     /// <summary>
     /// Get the tokens that have been read so far.
     /// </summary>
     /// <value>A new <see cref="SourceTokens"/> instance containing the tokens that have been read so far.</value>
-    protected SourceTokens ReadTokens => new(_tokens, _readCount);
+    SourceTokens ReadTokens => new(_tokens, _readCount);
+
+    /// <summary>
+    /// Get the parse this operation is part of.
+    /// </summary>
+    public ParseContext Context => _tokens.Context;
+
+    bool Failed => _error.HasValue;
+
+    ValueOption<Token> Next => _tokens.Peek(_readCount);
 
     /// <summary>
     /// Start a parsing operation.
     /// </summary>
     /// <param name="tokens">The input tokens.</param>
     /// <param name="production">Name of the production to parse.</param>
-    /// <returns>A new <see cref="ParseOperation"/>.</returns>
-    public static ParseOperation Start(IEnumerable<Token> tokens, string production) => new SuccessfulSoFarOperation(tokens, production);
-
-    /// <inheritdoc cref="Switch{T}(out Branch{T}, IReadOnlyDictionary{TokenType, Branch{T}}, Branch{T}?)"/>
-    public ParseOperation Switch<T>(out Branch<T> branch, Dictionary<TokenType, Branch<T>> cases, Branch<T>? @default = null) =>
-        Switch(out branch, (IReadOnlyDictionary<TokenType, Branch<T>>)cases, @default);
+    /// <returns>A <see cref="ParseOperation"/> from the pool.</returns>
+    public static ParseOperation Start(TokenCursor tokens, string production)
+    {
+        pool ??= new();
+        var operation = pool.TryPop(out var pooled) ? pooled : new();
+        operation._tokens = tokens;
+        operation._prod = production;
+        operation._readCount = 0;
+        operation._error = null;
+        return operation;
+    }
 
     /// <summary>
     /// Choose a branch to execute based on the type of the next token.
@@ -71,7 +92,24 @@ abstract class ParseOperation
     /// <param name="cases">The available branches, keyed by token type.</param>
     /// <param name="default">The default branch if the next token's type isn't a key in <paramref name="cases"/>. If the value <see langword="null"/> when this happens, this parse operation fails.</param>
     /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation Switch<T>(out Branch<T> branch, IReadOnlyDictionary<TokenType, Branch<T>> cases, Branch<T>? @default = null);
+    public ParseOperation Switch<T>(out Branch<T> branch, TokenTypeMap<Branch<T>> cases, Branch<T>? @default = null)
+    {
+        if (Failed) {
+            branch = default!;
+            return this;
+        }
+        var token = Next;
+        if (token.HasValue && cases.TryGetValue(token.Value.Type, out branch!)) {
+            _readCount++;
+            return this;
+        }
+        if (@default is not null) {
+            branch = @default;
+            return this;
+        }
+        branch = default!;
+        return Fail(ParseError.ForProduction(_prod, token, cases.Keys));
+    }
 
     /// <summary>
     /// Fork based on a previously chosen branch.
@@ -80,7 +118,15 @@ abstract class ParseOperation
     /// <param name="result">Assigned to the result creator. Pass it to <see cref="MapResult{T}"/> to retrieve the parse result.</param>
     /// <param name="branch">The branch to execute.</param>
     /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation Fork<T>(out ResultCreator<T> result, Branch<T> branch);
+    public ParseOperation Fork<T>(out ResultCreator<T> result, Branch<T> branch)
+    {
+        if (Failed) {
+            result = default!;
+            return this;
+        }
+        (ParseOperation p, result) = branch(this);
+        return p;
+    }
 
     /// <summary>
     /// Get a node based on the tokens read so far; the parsing operation can continue.
@@ -90,15 +136,49 @@ abstract class ParseOperation
     /// <param name="resultCreator">The result creator function.</param>
     /// <remarks>This method is the equivalent of <see cref="Parse{T}(out T, Parser{T})"/>, but without a parser.</remarks>
     /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation Get<T>(out T result, ResultCreator<T> resultCreator);
+    public ParseOperation Get<T>(out T result, ResultCreator<T> resultCreator)
+    {
+        result = Failed ? default! : resultCreator(ReadTokens.Location);
+        return this;
+    }
+
+    /// <inheritdoc cref="Get{T}(out T, ResultCreator{T})"/>
+    /// <typeparam name="TState">The type of the parsed values.</typeparam>
+    /// <param name="state">The parsed values to pass to <paramref name="resultCreator"/>.</param>
+    public ParseOperation Get<T, TState>(out T result, TState state, ResultCreator<TState, T> resultCreator)
+    {
+        result = Failed ? default! : resultCreator(ReadTokens.Location, state);
+        return this;
+    }
 
     /// <summary>
-    /// Retrieve the final result.
+    /// Retrieve the final result and end the operation.
     /// </summary>
     /// <typeparam name="T">The type of node to parse.</typeparam>
     /// <param name="resultCreator">The result creator function.</param>
     /// <returns>An Ok result containing the parsed node, or a failure result with a error indicating what went wrong.</returns>
-    public abstract ParseResult<T> MapResult<T>(ResultCreator<T> resultCreator);
+    public ParseResult<T> MapResult<T>(ResultCreator<T> resultCreator)
+    {
+        var readTokens = ReadTokens;
+        var result = _error is { } error
+            ? ParseResult.Fail<T>(Context, readTokens, error)
+            : ParseResult.Ok(readTokens, resultCreator(readTokens.Location));
+        pool!.Push(this);
+        return result;
+    }
+
+    /// <inheritdoc cref="MapResult{T}(ResultCreator{T})"/>
+    /// <typeparam name="TState">The type of the parsed values.</typeparam>
+    /// <param name="state">The parsed values to pass to <paramref name="resultCreator"/>.</param>
+    public ParseResult<T> MapResult<T, TState>(TState state, ResultCreator<TState, T> resultCreator)
+    {
+        var readTokens = ReadTokens;
+        var result = _error is { } error
+            ? ParseResult.Fail<T>(Context, readTokens, error)
+            : ParseResult.Ok(readTokens, resultCreator(readTokens.Location, state));
+        pool!.Push(this);
+        return result;
+    }
 
     /// <summary>Parse a single node.</summary>
     /// <typeparam name="T">The type of node to parse.</typeparam>
@@ -106,7 +186,21 @@ abstract class ParseOperation
     /// <param name="parse">The node parser.</param>
     /// <returns>The current <see cref="ParseOperation"/>.</returns>
     /// <remarks><paramref name="parse"/>'s failure fails this parsing operation.</remarks>
-    public abstract ParseOperation Parse<T>(out T result, Parser<T> parse);
+    public ParseOperation Parse<T>(out T result, Parser<T> parse)
+    {
+        if (Failed) {
+            result = default!;
+            return this;
+        }
+        var pr = CallParser(parse);
+        _readCount += pr.SourceTokens.Count;
+        if (pr.HasValue) {
+            result = pr.Value;
+            return this;
+        }
+        result = default!;
+        return Fail(MakeOurs(pr.Error));
+    }
 
     /// <summary>Parse one or more separated node.</summary>
     /// <typeparam name="T">The type of node to parse.</typeparam>
@@ -117,14 +211,36 @@ abstract class ParseOperation
     /// <param name="readEndToken">To read the end token.</param>
     /// <param name="allowTrailingSeparator">To allow a trailing separator.</param>
     /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation ParseOneOrMoreSeparated<T>(
+    public ParseOperation ParseOneOrMoreSeparated<T>(
         out IReadOnlyList<ParseResult<T>> result,
         Parser<T> parse,
         TokenType separator,
         TokenType end,
         bool readEndToken = true,
         bool allowTrailingSeparator = true
-    );
+    )
+    {
+        if (Failed) {
+            result = default!;
+            return this;
+        }
+
+        List<ParseResult<T>> items = [];
+        result = items;
+
+        if (Peek(end).ValueOr(true)) {
+            // try to parse to get an appropriate error, it should fail since we're on the end token.
+            return Fail(CallParser(parse).Error);
+        }
+
+        do {
+            var item = CallParser(parse);
+            _readCount += item.SourceTokens.Count;
+            items.Add(item);
+        } while (Match(separator) && (!allowTrailingSeparator || !Peek(end).ValueOr(true)));
+
+        return readEndToken ? ParseToken(end) : this;
+    }
 
     /// <summary>Parse one or more nodes until an end token is encountered.</summary>
     /// <typeparam name="T">The type of node to parse.</typeparam>
@@ -132,461 +248,268 @@ abstract class ParseOperation
     /// <param name="parse">The node parser.</param>
     /// <param name="endTokens">The set of end tokens.</param>
     /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation ParseOneOrMoreUntilToken<T>(out IReadOnlyList<ParseResult<T>> result, Parser<T> parse, TokenTypeSet endTokens);
-
-    /// <summary>Parse a node, optionally.</summary>
-    /// <typeparam name="T">The type of node to parse.</typeparam>
-    /// <param name="result">Assigned to the parsed node option.</param>
-    /// <param name="parse">The node parser.</param>
-    /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation ParseOptional<T>(out Option<T> result, Parser<T> parse);
-
-    /// <summary>Parse a node, optionally.</summary>
-    /// <typeparam name="T">The type of node to parse.</typeparam>
-    /// <param name="result">Assigned to the parsed node option.</param>
-    /// <param name="parse">The node parser.</param>
-    /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation ParseOptional<T>(out Option<T> result, ParseBlock<T> parse);
+    public ParseOperation ParseOneOrMoreUntilToken<T>(out IReadOnlyList<ParseResult<T>> result, Parser<T> parse, TokenTypeSet endTokens)
+    {
+        if (Failed) {
+            result = default!;
+            return this;
+        }
 
-    /// <summary>Parse a token, optionally.</summary>
-    /// <param name="type">The type of token to parse.</param>
-    /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation ParseOptionalToken(TokenType type);
+        List<ParseResult<T>> items = [];
+        result = items;
 
-    /// <summary>Parse a token.</summary>
-    /// <param name="type">The type of token to parse.</param>
-    /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation ParseToken(TokenType type);
+        ParseResult<T> item = CallParser(parse);
+        _readCount += item.SourceTokens.Count;
 
-    /// <summary>Parse a token.</summary>
-    /// <param name="type">The allowed types of the token to parse.</param>
-    /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation ParseToken(TokenTypeSet type);
+        items.Add(item);
 
-    /// <summary>Parse a contextual keyword, by expecting an identifier of the defined name.</summary>
-    /// <param name="contextKeyword">The contextual keyword to parse.</param>
-    /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation ParseContextKeyword(TokenType.ContextKeyword contextKeyword);
+        if (!item.HasValue) {
+            return Fail(MakeOurs(item.Error));
+        }
 
-    /// <summary>Parse a token's value.</summary>
-    /// <param name="result">Assigned to the parsed token's value.</param>
-    /// <param name="type">The type of token to parse.</param>
-    /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation ParseTokenValue(out string result, TokenType type);
+        ParseWhile(items, parse, endTokens);
 
-    /// <summary>Parse zero or more separated nodes.</summary>
-    /// <typeparam name="T">The type of node to parse.</typeparam>
-    /// <param name="separator">The separator token.</param>
-    /// <param name="end">The end token.</param>
-    /// <param name="readEndToken">To read the end token.</param>
-    /// <param name="allowTrailingSeparator">To allow a trailing separator.</param>
-    /// <param name="parse">The node parser.</param>
-    /// <param name="result">Assigned to the list of parsed nodes.</param>
-    /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation ParseZeroOrMoreSeparated<T>(
-        out IReadOnlyList<ParseResult<T>> result,
-        Parser<T> parse,
-        TokenType separator,
-        TokenType end,
-        bool readEndToken = true,
-        bool allowTrailingSeparator = true
-    );
+        return this;
+    }
 
-    /// <summary>Parse zero or more nodes until an end token is encountered.</summary>
+    /// <summary>Parse a node, optionally.</summary>
     /// <typeparam name="T">The type of node to parse.</typeparam>
-    /// <param name="result">Assigned to the list of parsed nodes.</param>
+    /// <param name="result">Assigned to the parsed node option.</param>
     /// <param name="parse">The node parser.</param>
-    /// <param name="endTokens">The set of end tokens.</param>
-    /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation ParseZeroOrMoreUntilToken<T>(out IReadOnlyList<ParseResult<T>> result, Parser<T> parse, TokenTypeSet endTokens);
-
-    /// <summary>Parse zero ore more nodes until an end token is encountered.</summary>
-    /// <typeparam name="T">The type of node to parse.</typeparam>
-    /// <param name="result">Assigned to the list of parsed nodes.</param>
-    /// <param name="block">The block to execute to get each node.</param>
-    /// <param name="endTokens">The set of end tokens.</param>
-    /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation ParseZeroOrMoreUntilToken<T>(out IReadOnlyList<ParseResult<T>> result, ParseBlock<T> block, TokenTypeSet endTokens);
-
-    /// <summary>
-    /// Skims <paramref name="n"/> tokens.
-    /// </summary>
-    /// <param name="n">The number of token to skim.</param>
     /// <returns>The current <see cref="ParseOperation"/>.</returns>
-    public abstract ParseOperation Skim(int n);
-
-    sealed class FailedOperation(IEnumerable<Token> tokens, int readCount, ParseError error) : ParseOperation(tokens, readCount)
+    public ParseOperation ParseOptional<T>(out Option<T> result, Parser<T> parse)
     {
-        readonly ParseError _error = error;
-
-        public override ParseOperation Switch<T>(out Branch<T> branch, IReadOnlyDictionary<TokenType, Branch<T>> cases, Branch<T>? @default)
-        {
-            branch = default!;
+        if (Failed) {
+            result = default!;
             return this;
         }
-
-        public override ParseOperation Fork<T>(out ResultCreator<T> resultCreator, Branch<T> branch)
-        {
-            resultCreator = default!;
-            return this;
+        var pr = CallParser(parse);
+        if (pr.HasValue) {
+            _readCount += pr.SourceTokens.Count;
         }
+        result = pr.DropError();
+        return this;
+    }
 
-        public override ParseOperation Get<T>(out T result, ResultCreator<T> resultCreator)
-        {
-            result = default!;
-            return this;
+    /// <summary>Parse a token, optionally.</summary>
+    /// <param name="type">The type of token to parse.</param>
+    /// <returns>The current <see cref="ParseOperation"/>.</returns>
+    public ParseOperation ParseOptionalToken(TokenType type)
+    {
+        if (!Failed && Next is { HasValue: true } token && token.Value.Type == type) {
+            _readCount++;
         }
+        return this;
+    }
 
-        public override ParseResult<T> MapResult<T>(ResultCreator<T> result) => ParseResult.Fail<T>(ReadTokens, _error);
-
-        public override ParseOperation Parse<T>(out T result, Parser<T> parse)
-        {
-            result = default!;
+    /// <summary>Parse a token.</summary>
+    /// <param name="type">The type of token to parse.</param>
+    /// <returns>The current <see cref="ParseOperation"/>.</returns>
+    public ParseOperation ParseToken(TokenType type)
+    {
+        if (Failed) {
             return this;
         }
-
-        public override ParseOperation ParseOneOrMoreSeparated<T>(
-            out IReadOnlyList<ParseResult<T>> result,
-            Parser<T> parse,
-            TokenType separator,
-            TokenType end,
-            bool readEndToken,
-            bool allowTrailingSeparator
-        )
-        {
-            result = default!;
+        var token = Next;
+        if (token.HasValue && token.Value.Type == type) {
+            _readCount++;
             return this;
         }
+        return Fail(ParseError.ForProduction(_prod, token, type));
+    }
 
-        public override ParseOperation ParseOneOrMoreUntilToken<T>(out IReadOnlyList<ParseResult<T>> result, Parser<T> parse, TokenTypeSet endTokens)
-        {
-            result = default!;
+    /// <summary>Parse a token.</summary>
+    /// <param name="result">The token parsed.</param>
+    /// <param name="type">The type of token to parse.</param>
+    /// <returns>The current <see cref="ParseOperation"/>.</returns>
+    public ParseOperation ParseToken(out Token result, TokenType type)
+    {
+        if (Failed) {
+            result = default;
             return this;
         }
-
-        public override ParseOperation ParseOptional<T>(out Option<T> result, Parser<T> parse)
-        {
-            result = default!;
+        var token = Next;
+        if (token.HasValue && token.Value.Type == type) {
+            _readCount++;
+            result = token.Value;
             return this;
         }
 
-        public override ParseOperation ParseOptionalToken(TokenType type) => this;
-        public override ParseOperation ParseToken(TokenType type) => this;
-        public override ParseOperation ParseToken(TokenTypeSet type) => this;
-
-        public override ParseOperation ParseTokenValue(out string result, TokenType type)
-        {
-            result = default!;
-            return this;
-        }
+        result = default;
+        return Fail(ParseError.ForProduction(_prod, token, type));
+    }
 
-        public override ParseOperation ParseZeroOrMoreSeparated<T>(
-            out IReadOnlyList<ParseResult<T>> result,
-            Parser<T> parse,
-            TokenType separator,
-            TokenType end,
-            bool readEndToken,
-            bool allowTrailingSeparator
-        )
-        {
-            result = default!;
+    /// <summary>Parse a token.</summary>
+    /// <param name="types">The allowed types of the token to parse.</param>
+    /// <returns>The current <see cref="ParseOperation"/>.</returns>
+    public ParseOperation ParseToken(TokenTypeSet types)
+    {
+        if (Failed) {
             return this;
         }
-
-        public override ParseOperation ParseZeroOrMoreUntilToken<T>(out IReadOnlyList<ParseResult<T>> result, Parser<T> parse, TokenTypeSet endTokens)
-        {
-            result = default!;
+        var token = Next;
+        if (token.HasValue && types.Contains(token.Value.Type)) {
+            _readCount++;
             return this;
         }
+        return Fail(ParseError.ForProduction(_prod, token, types));
+    }
 
-        public override ParseOperation ParseZeroOrMoreUntilToken<T>(out IReadOnlyList<ParseResult<T>> result, ParseBlock<T> block, TokenTypeSet endTokens)
-        {
-            result = default!;
+    /// <summary>Parse a contextual keyword, by expecting an identifier of the defined name.</summary>
+    /// <param name="contextKeyword">The contextual keyword to parse.</param>
+    /// <returns>The current <see cref="ParseOperation"/>.</returns>
+    public ParseOperation ParseContextKeyword(TokenType.ContextKeyword contextKeyword)
+    {
+        if (Failed) {
             return this;
         }
-
-        public override ParseOperation Skim(int n) => this;
-        public override ParseOperation ParseOptional<T>(out Option<T> result, ParseBlock<T> parse)
-        {
-            result = default!;
+        var token = Next;
+        if (token.HasValue && token.Value.Type == TokenType.Valued.Identifier && contextKeyword.IsMatch(token.Value.Value.Span)) {
+            _readCount++;
             return this;
         }
-
-        public override ParseOperation ParseContextKeyword(TokenType.ContextKeyword contextKeyword) => this;
+        return Fail(ParseError.ForContextKeyword(_prod, token, contextKeyword.Names));
     }
 
-    sealed class SuccessfulSoFarOperation(IEnumerable<Token> tokens, string production) : ParseOperation(tokens, 0)
+    /// <summary>Parse a token's value.</summary>
+    /// <param name="result">Assigned to the parsed token's value.</param>
+    /// <param name="type">The type of token to parse.</param>
+    /// <returns>The current <see cref="ParseOperation"/>.</returns>
+    public ParseOperation ParseTokenValue(out ReadOnlyMemory<char> result, TokenType type)
     {
-        readonly string _prod = production;
-
-        ValueOption<Token> Next => _tokens.ElementAtOrNone(_readCount);
-
-        ParseResult<T> CallParser<T>(Parser<T> parser) => parser(_tokens.Skip(_readCount));
-
-        public override ParseOperation Switch<T>(out Branch<T> branch, IReadOnlyDictionary<TokenType, Branch<T>> cases, Branch<T>? @default)
-        {
-            var token = Next;
-            if (token.HasValue && cases.TryGetValue(token.Value.Type, out branch!)) {
-                _readCount++;
-                return this;
-            }
-            if (@default is not null) {
-                branch = @default;
-                return this;
-            }
-            branch = default!;
-            return Fail(ParseError.ForProduction(_prod, token, cases.Keys.ToImmutableHashSet()));
-        }
-
-        public override ParseOperation Fork<T>(out ResultCreator<T> result, Branch<T> branch)
-        {
-            (ParseOperation p, result) = branch(this);
-            return p;
+        if (Failed) {
+            result = default;
+            return this;
         }
-
-        public override ParseOperation Get<T>(out T result, ResultCreator<T> resultCreator)
-        {
-            result = resultCreator(ReadTokens.Location);
+        var token = Next;
+        if (token.HasValue && token.Value.Type == type) {
+            _readCount++;
+            result = token.Value.Value;
             return this;
         }
 
-        public override ParseResult<T> MapResult<T>(ResultCreator<T> resultCreator) => MakeOkResult(resultCreator(ReadTokens.Location));
+        result = default;
+        return Fail(ParseError.ForProduction(_prod, token, type));
+    }
 
-        public override ParseOperation Parse<T>(out T result, Parser<T> parse)
-        {
-            var pr = CallParser(parse);
-            _readCount += pr.SourceTokens.Count;
-            if (pr.HasValue) {
-                result = pr.Value;
-                return this;
-            }
+    /// <summary>Parse zero or more separated nodes.</summary>
+    /// <typeparam name="T">The type of node to parse.</typeparam>
+    /// <param name="separator">The separator token.</param>
+    /// <param name="end">The end token.</param>
+    /// <param name="readEndToken">To read the end token.</param>
+    /// <param name="allowTrailingSeparator">To allow a trailing separator.</param>
+    /// <param name="parse">The node parser.</param>
+    /// <param name="result">Assigned to the list of parsed nodes.</param>
+    /// <returns>The current <see cref="ParseOperation"/>.</returns>
+    public ParseOperation ParseZeroOrMoreSeparated<T>(
+        out IReadOnlyList<ParseResult<T>> result,
+        Parser<T> parse,
+        TokenType separator,
+        TokenType end,
+        bool readEndToken = true,
+        bool allowTrailingSeparator = true
+    )
+    {
+        if (Failed) {
             result = default!;
-            return Fail(MakeOurs(pr.Error));
+            return this;
         }
 
-        public override ParseOperation ParseOneOrMoreSeparated<T>(
-            out IReadOnlyList<ParseResult<T>> result,
-            Parser<T> parse,
-            TokenType separator,
-            TokenType end,
-            bool readEndToken,
-            bool allowTrailingSeparator
-        )
-        {
-            List<ParseResult<T>> items = [];
-            result = items;
-
-            if (Peek(end).ValueOr(true)) {
-                // try to parse to get an appropriate error, it should fail since we're on the end token.
-                return Fail(CallParser(parse).Error.NotNull());
-            }
+        List<ParseResult<T>> items = [];
+        result = items;
 
+        if (!Peek(end).ValueOr(true)) {
             do {
                 var item = CallParser(parse);
                 _readCount += item.SourceTokens.Count;
                 items.Add(item);
             } while (Match(separator) && (!allowTrailingSeparator || !Peek(end).ValueOr(true)));
-
-            return readEndToken ? ParseToken(end) : this;
         }
 
-        public override ParseOperation ParseOneOrMoreUntilToken<T>(out IReadOnlyList<ParseResult<T>> result, Parser<T> parse, TokenTypeSet endTokens)
-        {
-            List<ParseResult<T>> items = [];
-            result = items;
-
-            ParseResult<T> item = CallParser(parse);
-            _readCount += item.SourceTokens.Count;
-
-            items.Add(item);
-
-            if (!item.HasValue) {
-                return Fail(MakeOurs(item.Error));
-            }
-
-            ParseWhile(items, parse, () => !Peek(endTokens).ValueOr(true));
-
-            return this;
-        }
-
-        public override ParseOperation ParseOptional<T>(out Option<T> result, Parser<T> parse)
-        {
-            var pr = CallParser(parse);
-            if (pr.HasValue) {
-                _readCount += pr.SourceTokens.Count;
-            }
-            result = pr.DropError();
-            return this;
-        }
-
-        public override ParseOperation ParseOptional<T>(out Option<T> result, ParseBlock<T> parse)
-        {
-            var pr = parse(this);
-
-            if (pr.HasValue) {
-                _readCount += pr.SourceTokens.Count;
-            }
-            result = pr.DropError();
-            return this;
-        }
-
-        public override ParseOperation ParseOptionalToken(TokenType type)
-        {
-            var token = Next;
-            if (token.HasValue && token.Value.Type == type) {
-                _readCount++;
-            }
-            return this;
-        }
-
-        public override ParseOperation ParseToken(TokenType type)
-        {
-            var token = Next;
-            if (token.HasValue && token.Value.Type == type) {
-                _readCount++;
-                return this;
-            }
-            return Fail(ParseError.ForProduction(_prod, token, type));
-        }
-
-        public override ParseOperation ParseToken(TokenTypeSet types)
-        {
-            var token = Next;
-            if (token.HasValue && types.Contains(token.Value.Type)) {
-                _readCount++;
-                return this;
-            }
-            return Fail(ParseError.ForProduction(_prod, token, types));
-        }
-
-        public override ParseOperation ParseContextKeyword(TokenType.ContextKeyword contextKeyword)
-        {
-            var token = Next;
-            if (token.HasValue && token.Value.Type == TokenType.Valued.Identifier && contextKeyword.Names.Contains(token.Value.Value.NotNull())) {
-                _readCount++;
-                return this;
-            }
-            return Fail(ParseError.ForContextKeyword(_prod, token, contextKeyword.Names));
-        }
-
-        public override ParseOperation ParseTokenValue(out string result, TokenType type)
-        {
-            var token = Next;
-            if (token.HasValue && token.Value.Type == type) {
-                _readCount++;
-                result = token.Value.Value ?? throw new InvalidOperationException("Parsed token doesn't have a value");
-                return this;
-            }
-
-            result = null!;
-            return Fail(ParseError.ForProduction(_prod, token, type));
-        }
-
-        public override ParseOperation ParseZeroOrMoreSeparated<T>(
-            out IReadOnlyList<ParseResult<T>> result,
-            Parser<T> parse,
-            TokenType separator,
-            TokenType end,
-            bool readEndToken,
-            bool allowTrailingSeparator
-        )
-        {
-            List<ParseResult<T>> items = [];
-            result = items;
-
-            if (!Peek(end).ValueOr(true)) {
-                do {
-                    var item = CallParser(parse);
-                    _readCount += item.SourceTokens.Count;
-                    items.Add(item);
-                } while (Match(separator) && (!allowTrailingSeparator || !Peek(end).ValueOr(true)));
-            }
-
-            if (allowTrailingSeparator) {
-                ParseOptionalToken(separator);
-            }
-
-            return readEndToken ? ParseToken(end) : this;
+        if (allowTrailingSeparator) {
+            ParseOptionalToken(separator);
         }
 
-        public override ParseOperation ParseZeroOrMoreUntilToken<T>(out IReadOnlyList<ParseResult<T>> result, Parser<T> parse, TokenTypeSet endTokens)
-        {
-            List<ParseResult<T>> items = [];
-            result = items;
-
-            ParseWhile(items, parse, () => !Peek(endTokens).ValueOr(true));
+        return readEndToken ? ParseToken(end) : this;
+    }
 
+    /// <summary>Parse zero or more nodes until an end token is encountered.</summary>
+    /// <typeparam name="T">The type of node to parse.</typeparam>
+    /// <param name="result">Assigned to the list of parsed nodes.</param>
+    /// <param name="parse">The node parser.</param>
+    /// <param name="endTokens">The set of end tokens.</param>
+    /// <returns>The current <see cref="ParseOperation"/>.</returns>
+    public ParseOperation ParseZeroOrMoreUntilToken<T>(out IReadOnlyList<ParseResult<T>> result, Parser<T> parse, TokenTypeSet endTokens)
+    {
+        if (Failed) {
+            result = default!;
             return this;
         }
 
-        public override ParseOperation ParseZeroOrMoreUntilToken<T>(out IReadOnlyList<ParseResult<T>> result, ParseBlock<T> block, TokenTypeSet endTokens)
-        {
-            List<ParseResult<T>> items = [];
-            result = items;
+        List<ParseResult<T>> items = [];
+        result = items;
 
-            ParseWhile(items, block, () => !Peek(endTokens).ValueOr(true));
+        ParseWhile(items, parse, endTokens);
 
-            return this;
-        }
+        return this;
+    }
 
-        public override ParseOperation Skim(int n)
-        {
+    /// <summary>
+    /// Skims <paramref name="n"/> tokens.
+    /// </summary>
+    /// <param name="n">The number of token to skim.</param>
+    /// <returns>The current <see cref="ParseOperation"/>.</returns>
+    public ParseOperation Skim(int n)
+    {
+        if (!Failed) {
             _readCount += n;
-            return this;
         }
+        return this;
+    }
 
-        bool Match(TokenType type)
-        {
-            bool nextIsSeparator = Peek(type).ValueOr(false);
-            if (nextIsSeparator) {
-                _readCount++;
-            }
-            return nextIsSeparator;
-        }
+    ParseResult<T> CallParser<T>(Parser<T> parser) => parser(_tokens.Advance(_readCount));
 
-        FailedOperation Fail(ParseError error) => new(_tokens, _readCount, error);
+    bool Match(TokenType type)
+    {
+        bool nextIsSeparator = Peek(type).ValueOr(false);
+        if (nextIsSeparator) {
+            _readCount++;
+        }
+        return nextIsSeparator;
+    }
 
-        ParseResult<T> MakeOkResult<T>(T result) => ParseResult.Ok(ReadTokens, result);
+    ParseOperation Fail(ParseError error)
+    {
+        _error = error;
+        return this;
+    }
 
-        ParseError MakeOurs(ParseError error) => _prod == error.FailedProduction
-            ? error
-            : ParseError.ForProduction(_prod, error.ErroneousToken, error.ExpectedTokens, error.FailedProduction);
+    ParseError MakeOurs(ParseError error) => _prod == error.FailedProduction
+        ? error
+        : ParseError.ForProduction(_prod, error.ErroneousToken, error.ExpectedTokens, error.FailedProduction);
 
-        ValueOption<bool> Peek(TokenTypeSet types) => Next.Map(token => types.Contains(token.Type));
+    ValueOption<bool> Peek(TokenTypeSet types) => Next is { HasValue: true } token ? types.Contains(token.Value.Type) : default(ValueOption<bool>);
 
-        ValueOption<bool> Peek(TokenType type) => Next.Map(token => type.Equals(token.Type));
+    ValueOption<bool> Peek(TokenType type) => Next is { HasValue: true } token ? type.Equals(token.Value.Type) : default(ValueOption<bool>);
 
-        void ParseWhile<T>(ICollection<ParseResult<T>> items, Parser<T> parse, Func<bool> keepGoingWhile)
-        {
-            bool prevFailedWith0SrcTokens = false;
-            while (keepGoingWhile()) {
-                var prItem = CallParser(parse);
-                _readCount += prItem.SourceTokens.Count;
+    bool IsAtEnd(TokenTypeSet endTokens) => Peek(endTokens).ValueOr(true);
 
-                {
-                    var thisFailedWith0SrcTokens = prItem is { HasValue: false, SourceTokens.Count: 0 };
-                    if (prevFailedWith0SrcTokens && thisFailedWith0SrcTokens) {
-                        break;
-                    }
-                    prevFailedWith0SrcTokens = thisFailedWith0SrcTokens;
+    void ParseWhile<T>(List<ParseResult<T>> items, Parser<T> parse, TokenTypeSet endTokens)
+    {
+        bool prevFailedWith0SrcTokens = false;
+        while (!IsAtEnd(endTokens)) {
+            var prItem = CallParser(parse);
+            _readCount += prItem.SourceTokens.Count;
+
+            {
+                var thisFailedWith0SrcTokens = prItem is { HasValue: false, SourceTokens.Count: 0 };
+                if (prevFailedWith0SrcTokens && thisFailedWith0SrcTokens) {
+                    break;
                 }
-
-                items.Add(prItem);
+                prevFailedWith0SrcTokens = thisFailedWith0SrcTokens;
             }
-        }
 
-        void ParseWhile<T>(ICollection<ParseResult<T>> items, ParseBlock<T> block, Func<bool> keepGoingWhile)
-        {
-            if (!keepGoingWhile()) {
-                return;
-            }
-
-            var prItem = block(this);
-
-            while (keepGoingWhile()) {
-                items.Add(prItem);
-                prItem = block(this);
-            }
+            items.Add(prItem);
         }
     }
 }
@@ -1,35 +1,70 @@
+using System.Diagnostics;
+using System.Diagnostics.CodeAnalysis;
+
 namespace Scover.Psdc.Parsing;
 
-public interface ParseResult<out T> : Option<T, ParseError>
+/// <summary>
+/// The result of parsing a production: the parsed node or a syntax error, and the tokens that were read.
+/// </summary>
+/// <typeparam name="T">The type of node parsed.</typeparam>
+/// <remarks>
+/// <para>This is a value type, so that parsing doesn't allocate results. Since it can't be covariant, convert it explicitly with <see cref="ParseResult.Upcast{T, TBase}(ParseResult{T})"/>.</para>
+/// <para>The error of a failed result is held by its parse, so that failing doesn't allocate either, and only read while the parse is running.</para>
+/// </remarks>
+public readonly struct ParseResult<T> : Option<T, ParseError>
 {
-    SourceTokens SourceTokens { get; }
+    // The parse holding the error of a failed result, or null if the result has a value.
+    readonly ParseContext? _failedIn;
+    readonly int _errorIndex;
+
+    internal ParseResult(T value, SourceTokens sourceTokens) => (Value, SourceTokens) = (value, sourceTokens);
+
+    internal ParseResult(ParseContext failedIn, int errorIndex, SourceTokens sourceTokens)
+     => (_failedIn, _errorIndex, SourceTokens) = (failedIn, errorIndex, sourceTokens);
+
+    [MemberNotNullWhen(true, nameof(Value))]
+    public bool HasValue => _failedIn is null;
+    public T? Value { get; }
+    /// <summary>Gets the syntax error, or the default error if this result has a value.</summary>
+    public ParseError Error => _failedIn is null ? default : _failedIn.GetError(_errorIndex);
+    public SourceTokens SourceTokens { get; }
 
-    ParseResult<T> WithSourceTokens(SourceTokens newSourceTokens);
+    public ParseResult<T> WithSourceTokens(SourceTokens newSourceTokens) => _failedIn is null
+        ? new(Value!, newSourceTokens)
+        : new(_failedIn, _errorIndex, newSourceTokens);
+
+    /// <summary>Drops the error, without boxing this result.</summary>
+    public ValueOption<T> DropError() => HasValue ? Value.Some() : default;
+
+    /// <summary>Creates a failed result of another type, with the error of this failed result.</summary>
+    internal ParseResult<TOther> Propagate<TOther>(SourceTokens sourceTokens)
+    {
+        Debug.Assert(_failedIn is not null);
+        return new(_failedIn, _errorIndex, sourceTokens);
+    }
 }
+
 static class ParseResult
 {
-    public static ParseResult<T> Fail<T>(SourceTokens sourceTokens, ParseError error) => new ParseResultImpl<T>(false, default, error, sourceTokens);
+    public static ParseResult<T> Fail<T>(ParseContext context, SourceTokens sourceTokens, ParseError error) =>
+        new(context, context.AddError(error), sourceTokens);
+
+    public static ParseResult<T> Ok<T>(SourceTokens sourceTokens, T result) => new(result, sourceTokens);
 
     public static ParseResult<TResult> FlatMap<T, TResult>(this ParseResult<T> pr, Func<T, ParseResult<TResult>> transform) =>
-        pr.HasValue ? transform(pr.Value) : Fail<TResult>(pr.SourceTokens, pr.Error);
+        pr.HasValue ? transform(pr.Value) : pr.Propagate<TResult>(pr.SourceTokens);
 
     public static ParseResult<TResult> Map<T, TResult>(this ParseResult<T> original, Func<SourceTokens, T, TResult> transform) => original.HasValue
         ? Ok(original.SourceTokens, transform(original.SourceTokens, original.Value))
-        : Fail<TResult>(original.SourceTokens, original.Error);
+        : original.Propagate<TResult>(original.SourceTokens);
 
-    public static ParseResult<T> MapError<T>(this ParseResult<T> result, Func<ParseError, ParseError> transformError) => result.HasValue
+    /// <summary>Combines the error of a failed result with the error of a previously failed alternative.</summary>
+    public static ParseResult<T> CombineError<T>(this ParseResult<T> result, ParseContext context, ParseError previousError) => result.HasValue
         ? result
-        : Fail<T>(result.SourceTokens, transformError(result.Error));
+        : Fail<T>(context, result.SourceTokens, previousError.CombineWith(result.Error));
 
-    public static ParseResult<T> Ok<T>(SourceTokens sourceTokens, T result) => new ParseResultImpl<T>(true, result, null, sourceTokens);
-
-    sealed record ParseResultImpl<T>(
-        bool HasValue,
-        T? Value,
-        ParseError? Error,
-        SourceTokens SourceTokens
-    ) : ParseResult<T>
-    {
-        public ParseResult<T> WithSourceTokens(SourceTokens newSourceTokens) => this with { SourceTokens = newSourceTokens };
-    }
+    /// <summary>Converts a result to a result of a base type of its node.</summary>
+    public static ParseResult<TBase> Upcast<T, TBase>(this ParseResult<T> result) where T : TBase => result.HasValue
+        ? Ok<TBase>(result.SourceTokens, result.Value)
+        : result.Propagate<TBase>(result.SourceTokens);
 }
@@ -1,4 +1,3 @@
-using System.Collections.Immutable;
 using System.Diagnostics;
 using System.Diagnostics.CodeAnalysis;
 
@@ -11,7 +10,7 @@ namespace Scover.Psdc.Parsing;
 
 partial class Parser
 {
-    static readonly Dictionary<TokenType, ResultCreator<BinaryOperator>>
+    static readonly TokenTypeMap<ResultCreator<BinaryOperator>>
         operatorsOr = new() { [Keyword.Or] = t => new BinaryOperator.Or(t) },
         operatorsAnd = new() { [Keyword.And] = t => new BinaryOperator.And(t) },
         operatorsXor = new() { [Keyword.Xor] = t => new BinaryOperator.Xor(t) },
@@ -31,105 +30,215 @@ partial class Parser
             [Punctuation.Mod] = t => new BinaryOperator.Mod(t),
         };
 
+    // Binding power of each binary operator, from the loosest (or) to the tightest (multiplicative) operators.
+    static readonly TokenTypeMap<(int BindingPower, ResultCreator<BinaryOperator> CreateOperator)> binaryOperators = new(
+        new[] { operatorsOr, operatorsAnd, operatorsXor, operatorsEquality, operatorsComparison, operatorsAddSub, operatorsMulDivMod }
+           .SelectMany((operators, i) => operators.Select(kvp => KeyValuePair.Create(kvp.Key, (BindingPower: i + 1, CreateOperator: kvp.Value)))));
+
     readonly Parser<Expr.Literal> _literal;
-    delegate ParseResult<TRight> RightParser<in TLeft, out TRight>(TLeft left, IEnumerable<Token> rightTokens);
-
-    Parser<Expr>? _expressionParser;
-
-    [SuppressMessage("ReSharper", "MissingIndent")]
-    ParseResult<Expr> Expression(IEnumerable<Token> tokens) => (_expressionParser ??=
-        ParserBinaryOperation(operatorsOr,
-        ParserBinaryOperation(operatorsAnd,
-        ParserBinaryOperation(operatorsXor,
-        ParserBinaryOperation(operatorsEquality,
-        ParserBinaryOperation(operatorsComparison,
-        ParserBinaryOperation(operatorsAddSub,
-        ParserBinaryOperation(operatorsMulDivMod,
-        ParserUnaryOperation(
-        ParserBinary(TerminalRvalue, new() {
-            [Punctuation.LBracket] = ArraySubscriptRight,
-            [Punctuation.Dot] = ComponentAccessRight,
-        }))))))))))(tokens);
-
-    static Parser<T> ParserBinary<T>(
-        Parser<T> leftParser,
-        Dictionary<TokenType, RightParser<T, T>> rightParsers
-    ) => tokens => {
-        var result = leftParser(tokens);
-        int count = result.SourceTokens.Count;
-
-        while (result.HasValue && TryGetRightParser(out var rightParser, rightParsers, tokens, count)) {
-            ++count;
-            result = rightParser(result.Value, tokens.Skip(count));
-            count += result.SourceTokens.Count;
+    delegate ParseResult<TRight> RightParser<in TLeft, TRight>(TLeft left, TokenCursor rightTokens);
+
+    readonly Parser<UnaryOperator> _parseUnaryOperator;
+    readonly TokenTypeMap<RightParser<Expr, Expr.Lvalue>> _accessParsers;
+    readonly Parser<Expr.Lvalue> _lvalueParser;
+    readonly Parser<Expr.Lvalue> _terminalLvalueParser;
+    readonly Parser<Expr> _terminalRvalueParser;
+
+    /// <summary>
+    /// An operator of an expression being parsed that waits for its operands, or an opening parenthesis, which waits for its closing parenthesis.
+    /// </summary>
+    /// <param name="Offset">The offset of the operator from the start of the expression.</param>
+    /// <param name="Operator">The unary or binary operator, or <see langword="null"/> for an opening parenthesis.</param>
+    /// <param name="BindingPower">The binding power of a binary operator.</param>
+    internal readonly record struct PendingOperator(int Offset, Node? Operator, int BindingPower = 0);
+
+    ParseResult<Expr> Expression(TokenCursor tokens)
+    {
+        if (!tokens.Context.TryEnterNesting(tokens)) {
+            return NestingTooDeep<Expr>(tokens, "expression");
+        }
+        var result = Operations(tokens);
+        tokens.Context.ExitNesting();
+        return result;
+    }
+
+    /// <summary>
+    /// Parses operands, and the operators and parentheses around them.
+    /// </summary>
+    /// <param name="tokens">The input tokens.</param>
+    /// <returns>The operand, operation or parenthesized expression parsed.</returns>
+    /// <remarks>
+    /// <para>The operators and parentheses are parsed in a loop, with the operands and the operators that wait for them on stacks, so they don't count as nesting.
+    /// Only operands that contain expressions, such as calls and subscripts, recurse.</para>
+    /// <para>Binary operators are left-associative: each one first applies the pending operators that bind at least as tightly.
+    /// Unary operators apply to their operand with its subscripts and component accesses.</para>
+    /// </remarks>
+    ParseResult<Expr> Operations(TokenCursor tokens)
+    {
+        var operands = tokens.Context.Operands;
+        var operators = tokens.Context.Operators;
+        int operandsStart = operands.Count, operatorsStart = operators.Count;
+        int count = 0, openParentheses = 0;
+        bool parenthesesStart = false;
+
+        while (true) {
+            // Read the unary operators and opening parentheses before an operand.
+            while (true) {
+                if (!(parenthesesStart && IsParenthesizedVariable(tokens, count))
+                 && _parseUnaryOperator(tokens.Advance(count)) is { HasValue: true } prOp) {
+                    operators.Push(new(count, prOp.Value));
+                    count += prOp.SourceTokens.Count;
+                    parenthesesStart = false;
+                } else if (tokens.Peek(count) is { HasValue: true } lParen && lParen.Value.Type == Punctuation.LParen) {
+                    operators.Push(new(count, null));
+                    ++count;
+                    ++openParentheses;
+                    parenthesesStart = true;
+                } else {
+                    break;
+                }
+            }
+
+            // Parentheses have been read, so terminals don't try them.
+            var prOperand = TerminalRvalue(tokens.Advance(count));
+            if (!prOperand.HasValue) {
+                return Fail(prOperand.SourceTokens.Count, prOperand.Error);
+            }
+            operands.Push((count, prOperand.Value));
+            count += prOperand.SourceTokens.Count;
+
+            while (true) {
+                while (TryGetRightParser(out var accessParser, _accessParsers, tokens, count)) {
+                    ++count;
+                    var (offset, accessed) = operands.Pop();
+                    var prAccess = accessParser(accessed, tokens.Advance(count));
+                    if (!prAccess.HasValue) {
+                        return Fail(prAccess.SourceTokens.Count, prAccess.Error);
+                    }
+                    operands.Push((offset, prAccess.Value));
+                    count += prAccess.SourceTokens.Count;
+                }
+
+                // Apply the unary operators from the innermost.
+                while (operators.Count != operatorsStart && operators.Peek().Operator is UnaryOperator unaryOperator) {
+                    int offset = operators.Pop().Offset;
+                    operands.Push((offset, new Expr.UnaryOperation(Location(offset), unaryOperator, operands.Pop().Expr)));
+                }
+
+                if (openParentheses == 0 || tokens.Peek(count) is not { HasValue: true } rParen || rParen.Value.Type != Punctuation.RParen) {
+                    break;
+                }
+
+                // The parenthesized expression is an operand of the operators before the opening parenthesis.
+                ApplyBinaryOperators(0);
+                int lParenOffset = operators.Pop().Offset;
+                --openParentheses;
+                ++count;
+                var contained = operands.Pop().Expr;
+                operands.Push((lParenOffset, contained is Expr.Lvalue lvalue
+                    ? new Expr.Lvalue.ParenLValue(Location(lParenOffset), lvalue)
+                    : new Expr.ParenExprImpl(Location(lParenOffset), contained)));
+            }
+
+            if (tokens.Peek(count) is { HasValue: true } opToken && binaryOperators.TryGetValue(opToken.Value.Type, out var op)) {
+                ApplyBinaryOperators(op.BindingPower);
+                operators.Push(new(count, op.CreateOperator(opToken.Value.Position), op.BindingPower));
+                ++count;
+                parenthesesStart = false;
+                continue;
+            }
+
+            if (openParentheses != 0) {
+                return Fail(0, ParseError.ForProduction("parenthesized expression", tokens.Peek(count), Punctuation.RParen));
+            }
+
+            ApplyBinaryOperators(0);
+            var expr = operands.Pop().Expr;
+            Debug.Assert(operands.Count == operandsStart && operators.Count == operatorsStart);
+            return ParseResult.Ok(new(tokens, count), expr);
+        }
+
+        Range Location(int offset) => new SourceTokens(tokens.Advance(offset), count - offset).Location;
+
+        // Applies the pending binary operators that bind at least as tightly, up to the last opening parenthesis.
+        void ApplyBinaryOperators(int minBindingPower)
+        {
+            while (operators.Count != operatorsStart
+                && operators.Peek() is { Operator: BinaryOperator binaryOperator } pending
+                && pending.BindingPower >= minBindingPower) {
+                operators.Pop();
+                var right = operands.Pop().Expr;
+                var (offset, left) = operands.Pop();
+                operands.Push((offset, new Expr.BinaryOperation(Location(offset), left, binaryOperator, right)));
+            }
         }
 
-        return result.WithSourceTokens(new(tokens, count));
-    };
+        ParseResult<Expr> Fail(int failedCount, ParseError error)
+        {
+            while (operands.Count != operandsStart) {
+                operands.Pop();
+            }
+            while (operators.Count != operatorsStart) {
+                operators.Pop();
+            }
+            return ParseResult.Fail<Expr>(tokens.Context, new(tokens, count + failedCount), error);
+        }
+    }
+
+    // Whether the next tokens are an identifier in parentheses, followed by a closing parenthesis, a subscript or a component access.
+    // Parenthesized again, the identifier is a variable, not the target type of a cast.
+    static bool IsParenthesizedVariable(TokenCursor tokens, int offset) => tokens.Peek(offset) is { HasValue: true } lParen
+     && lParen.Value.Type == Punctuation.LParen
+     && tokens.Peek(offset + 1) is { HasValue: true } identifier
+     && identifier.Value.Type == Valued.Identifier
+     && tokens.Peek(offset + 2) is { HasValue: true } rParen
+     && rParen.Value.Type == Punctuation.RParen
+     && tokens.Peek(offset + 3) is { HasValue: true } next
+     && (next.Value.Type == Punctuation.RParen || next.Value.Type == Punctuation.LBracket || next.Value.Type == Punctuation.Dot);
 
     static Parser<TRight> ParserBinaryAtLeast1<TLeft, TRight>(
         string production,
         Parser<TLeft> leftParser,
-        Dictionary<TokenType, RightParser<TLeft, TRight>> rightParsers
+        TokenTypeMap<RightParser<TLeft, TRight>> rightParsers
     )
-    where TRight : TLeft => tokens => {
-        ParseResult<TLeft> leftSeed = leftParser(tokens);
-        int count = leftSeed.SourceTokens.Count;
-
-        // Since a TLeft can't be returned in place of a TRight, we don't allow only having a TLeft parsed.
-        // This is different from binary operations.
-        // The initial TLeft serves as a seed for the rightParsers.
-        if (!leftSeed.HasValue) {
-            return ParseResult.Fail<TRight>(leftSeed.SourceTokens, leftSeed.Error);
-        }
-        if (!TryGetRightParser(out var rightParse, rightParsers, tokens, count)) {
-            return ParseResult.Fail<TRight>(leftSeed.SourceTokens,
-                ParseError.ForProduction(production, tokens.ElementAtOrNone(count), rightParsers.Keys.ToImmutableHashSet()));
-        }
+    where TRight : TLeft
+    {
+        return tokens => {
+            ParseResult<TLeft> leftSeed = leftParser(tokens);
+            int count = leftSeed.SourceTokens.Count;
 
-        ParseResult<TRight> result;
-        TLeft? lastValue = leftSeed.Value;
-        do {
-            ++count; // read right parser token
-            result = rightParse(lastValue, tokens.Skip(count));
-            count += result.SourceTokens.Count;
-            lastValue = result.Value;
-        } while (lastValue is not null && TryGetRightParser(out rightParse, rightParsers, tokens, count));
-
-        return result.WithSourceTokens(new(tokens, count));
-    };
-
-    static Parser<Expr> ParserBinaryOperation(
-        IReadOnlyDictionary<TokenType, ResultCreator<BinaryOperator>> operators,
-        Parser<Expr> descentParser
-    ) => tokens => {
-        var prLeft = descentParser(tokens);
-        int count = prLeft.SourceTokens.Count;
-
-        while (prLeft.HasValue
-            && GetByTokenType(tokens.Skip(count), "operator", operators)
-                   is { HasValue: true } prOp) {
-            count += prOp.SourceTokens.Count;
-            var prRright = descentParser(tokens.Skip(count));
-            count += prRright.SourceTokens.Count;
-
-            prLeft = prRright.WithSourceTokens(new(tokens, count)).Map((srcTokens, right)
-                // ReSharper disable once AccessToModifiedClosure
-                // Justification: the closure is executed immediately
-                => new Expr.BinaryOperation(srcTokens.Location, prLeft.Value, prOp.Value(prOp.SourceTokens.Location), right));
-        }
+            // Since a TLeft can't be returned in place of a TRight, we don't allow only having a TLeft parsed.
+            // This is different from binary operations.
+            // The initial TLeft serves as a seed for the rightParsers.
+            if (!leftSeed.HasValue) {
+                return leftSeed.Propagate<TRight>(leftSeed.SourceTokens);
+            }
+            if (!TryGetRightParser(out var rightParse, rightParsers, tokens, count)) {
+                return ParseResult.Fail<TRight>(tokens.Context, leftSeed.SourceTokens,
+                    ParseError.ForProduction(production, tokens.Peek(count), rightParsers.Keys));
+            }
 
-        return prLeft;
-    };
+            ParseResult<TRight> result;
+            TLeft? lastValue = leftSeed.Value;
+            do {
+                ++count; // read right parser token
+                result = rightParse(lastValue, tokens.Advance(count));
+                count += result.SourceTokens.Count;
+                lastValue = result.Value;
+            } while (lastValue is not null && TryGetRightParser(out rightParse, rightParsers, tokens, count));
+
+            return result.WithSourceTokens(new(tokens, count));
+        };
+    }
 
     static bool TryGetRightParser<TLeft, TRight>(
         [NotNullWhen(true)] out RightParser<TLeft, TRight>? right,
-        IReadOnlyDictionary<TokenType, RightParser<TLeft, TRight>> rightParsers,
-        IEnumerable<Token> tokens,
+        TokenTypeMap<RightParser<TLeft, TRight>> rightParsers,
+        TokenCursor tokens,
         int count
     )
     {
-        if (tokens.ElementAtOrNone(count) is { HasValue: true } middle
+        if (tokens.Peek(count) is { HasValue: true } middle
          && rightParsers.TryGetValue(middle.Value.Type, out right)) {
             return true;
         }
@@ -137,81 +246,46 @@ partial class Parser
         return false;
     }
 
-    ParseResult<Expr> ParenExpr(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "parenthesized expression")
+    ParseResult<Expr> ParenExpr(TokenCursor tokens) => ParseOperation.Start(tokens, "parenthesized expression")
        .ParseToken(Punctuation.LParen)
        .Parse(out var expression, Expression)
        .ParseToken(Punctuation.RParen)
-       .MapResult(t => new Expr.ParenExprImpl(t, expression));
+       .MapResult(expression, static Expr (t, expression) => new Expr.ParenExprImpl(t, expression));
 
-    ParseResult<Expr.Lvalue> ParenLvalue(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "parenthesized lvalue")
+    ParseResult<Expr.Lvalue> ParenLvalue(TokenCursor tokens) => ParseOperation.Start(tokens, "parenthesized lvalue")
        .ParseToken(Punctuation.LParen)
        .Parse(out var expression, ParseLvalue)
        .ParseToken(Punctuation.RParen)
-       .MapResult(t => new Expr.Lvalue.ParenLValue(t, expression));
+       .MapResult(expression, static Expr.Lvalue (t, expression) => new Expr.Lvalue.ParenLValue(t, expression));
 
-    ParseResult<Expr.BuiltinFdf> BuiltinFdf(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "FdF call")
+    ParseResult<Expr> BuiltinFdf(TokenCursor tokens) => ParseOperation.Start(tokens, "FdF call")
        .ParseToken(Keyword.Fdf)
        .ParseToken(Punctuation.LParen)
        .Parse(out var argNomLog, Expression)
        .ParseToken(Punctuation.RParen)
-       .MapResult(t => new Expr.BuiltinFdf(t, argNomLog));
-
-    Parser<Expr> ParserUnaryOperation(
-        Parser<Expr> descentParser
-    ) => tokens => {
-        var prOp = ParseUnaryOperator(tokens);
-        return prOp.Match(
-            op => {
-                var prOperand = ParserUnaryOperation(descentParser)(tokens.Skip(prOp.SourceTokens.Count));
-                return prOperand.WithSourceTokens(new(tokens, prOp.SourceTokens.Count + prOperand.SourceTokens.Count))
-                   .Map((t, expr) => new Expr.UnaryOperation(t.Location, op, expr));
-            },
-            _ => descentParser(tokens));
-    };
-
-    Parser<UnaryOperator>? _parseUnaryOperator;
-    Parser<UnaryOperator> ParseUnaryOperator => _parseUnaryOperator ??= ParserFirst<UnaryOperator>(
-        t => ParseToken(t, Punctuation.Minus, t => new UnaryOperator.Minus(t)),
-        t => ParseToken(t, Keyword.Not, t => new UnaryOperator.Not(t)),
-        t => ParseToken(t, Punctuation.Plus, t => new UnaryOperator.Plus(t)),
-        t => ParseOperation.Start(t, "cast operator")
-           .ParseToken(Punctuation.LParen)
-           .Parse(out var target, _type)
-           .ParseToken(Punctuation.RParen)
-           .MapResult(t => new UnaryOperator.Cast(t, target)));
-
-    ParseResult<Expr.Call> Call(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "call")
+       .MapResult(argNomLog, static Expr (t, argNomLog) => new Expr.BuiltinFdf(t, argNomLog));
+
+    ParseResult<Expr> Call(TokenCursor tokens) => ParseOperation.Start(tokens, "call")
        .Parse(out var name, Identifier)
        .ParseToken(Punctuation.LParen)
        .ParseZeroOrMoreSeparated(out var parameters, ParameterActual, Punctuation.Comma, Punctuation.RParen)
-       .MapResult(t => new Expr.Call(t, name, ReportErrors(parameters)));
+       .MapResult((tokens.Context, name, parameters), static Expr (t, s) => new Expr.Call(t, s.name, ReportErrors(s.Context, s.parameters)));
 
-    ParseResult<Expr.Lvalue> ParseLvalue(IEnumerable<Token> tokens) =>
-        ParserFirst(
-            ParserBinaryAtLeast1<Expr, Expr.Lvalue>("lvalue", TerminalRvalue,
-                new() { [Punctuation.LBracket] = ArraySubscriptRight, [Punctuation.Dot] = ComponentAccessRight }), TerminalLvalue)(tokens);
+    ParseResult<Expr.Lvalue> ParseLvalue(TokenCursor tokens) => _lvalueParser(tokens);
 
-    ParseResult<Expr.Lvalue> TerminalLvalue(IEnumerable<Token> tokens) => ParserFirst(
-        t => Identifier(tokens)
-           .Map((t, name) => new Expr.Lvalue.VariableReference(t.Location, name)),
-        ParenLvalue)(tokens);
+    ParseResult<Expr.Lvalue> TerminalLvalue(TokenCursor tokens) => _terminalLvalueParser(tokens);
 
-    ParseResult<Expr> TerminalRvalue(IEnumerable<Token> tokens) => ParserFirst(
-        _literal,
-        Call,
-        TerminalLvalue,
-        ParenExpr,
-        BuiltinFdf)(tokens);
+    ParseResult<Expr> TerminalRvalue(TokenCursor tokens) => _terminalRvalueParser(tokens);
 
     ParseResult<Expr.Lvalue> ArraySubscriptRight(
         Expr expr,
-        IEnumerable<Token> rightTokens
+        TokenCursor rightTokens
     ) => ParseOperation.Start(rightTokens, "array subscript")
        .ParseOneOrMoreSeparated(out var indexes, Expression,
             Punctuation.Comma, Punctuation.RBracket)
-       .MapResult(t => {
-            var result = expr;
-            var ind = ReportErrors(indexes).AsSpan();
+       .MapResult((rightTokens.Context, expr, indexes), static Expr.Lvalue (t, s) => {
+            var result = s.expr;
+            var ind = ReportErrors(s.Context, s.indexes).AsSpan();
             Debug.Assert(!ind.IsEmpty);
             foreach (var index in ind) {
                 result = new Expr.Lvalue.ArraySubscript(index.Location, result, index);
@@ -221,8 +295,8 @@ partial class Parser
 
     ParseResult<Expr.Lvalue> ComponentAccessRight(
         Expr expr,
-        IEnumerable<Token> rightTokens
+        TokenCursor rightTokens
     ) => ParseOperation.Start(rightTokens, "component access")
        .Parse(out var component, Identifier)
-       .MapResult(t => new Expr.Lvalue.ComponentAccess(t, expr, component));
+       .MapResult((expr, component), static Expr.Lvalue (t, s) => new Expr.Lvalue.ComponentAccess(t, s.expr, s.component));
 }
@@ -1,4 +1,5 @@
 using System.Collections.Immutable;
+using System.Diagnostics.CodeAnalysis;
 
 using Scover.Psdc.Lexing;
 
@@ -6,61 +7,96 @@ namespace Scover.Psdc.Parsing;
 
 partial class Parser
 {
-    static ParseResult<T> GetByTokenType<T>(IEnumerable<Token> tokens, string production, IReadOnlyDictionary<TokenType, T> map)
+    static ParseResult<T> GetByTokenType<T>(TokenCursor tokens, string production, TokenTypeMap<T> map)
     {
-        var firstToken = tokens.FirstOrNone();
+        var firstToken = tokens.Peek();
         return firstToken.HasValue && map.TryGetValue(firstToken.Value.Type, out var t)
             ? ParseResult.Ok(new(tokens, 1), t)
-            : ParseResult.Fail<T>(firstToken.Map(t => new SourceTokens(t)).ValueOr(SourceTokens.Empty),
-                ParseError.ForProduction(production, firstToken, map.Keys.ToImmutableHashSet()));
+            : ParseResult.Fail<T>(tokens.Context, firstToken.Map(t => new SourceTokens(t)).ValueOr(SourceTokens.Empty),
+                ParseError.ForProduction(production, firstToken, map.Keys));
     }
 
+    /// <summary>
+    /// Creates a parser of a construct that counts as a level of nesting.
+    /// </summary>
+    /// <remarks>Nesting depth is limited so that deeply nested input fails with an error, instead of overflowing the stack here or in later compilation stages.</remarks>
+    static Parser<T> ParserNested<T>(string production, Parser<T> parser) => tokens => {
+        if (!tokens.Context.TryEnterNesting(tokens)) {
+            return NestingTooDeep<T>(tokens, production);
+        }
+        var result = parser(tokens);
+        tokens.Context.ExitNesting();
+        return result;
+    };
+
+    // The error is reported by TryEnterNesting; this failure only stops the enclosing productions.
+    static ParseResult<T> NestingTooDeep<T>(TokenCursor tokens, string production)
+     => ParseResult.Fail<T>(tokens.Context, SourceTokens.Empty, ParseError.ForProduction(production, tokens.Peek(), TokenTypeSet.Empty));
+
+    /// <summary>Converts a parser to a parser of a base type of its node.</summary>
+    static Parser<TBase> ParserUpcast<T, TBase>(Parser<T> parser) where T : TBase => tokens => parser(tokens).Upcast<T, TBase>();
+
     static Parser<T> ParserReturn<T>(int tokenCount, ResultCreator<T> makeNode) where T : Node => tokens => {
         SourceTokens sourceTokens = new(tokens, tokenCount);
         return ParseResult.Ok(sourceTokens, makeNode(sourceTokens.Location));
     };
 
-    static Parser<T> ParserReturn1<T>(ValuedResultCreator<T> makeNodeWithValue) where T : Node => tokens => {
+    static Parser<T> ParserReturn1<T>(Func<Range, Token, T> makeNodeWithToken) where T : Node => tokens => {
         SourceTokens sourceTokens = new(tokens, 1);
-        return ParseResult.Ok(sourceTokens, makeNodeWithValue(sourceTokens.Location, tokens.First().Value.NotNull()));
+        return ParseResult.Ok(sourceTokens, makeNodeWithToken(sourceTokens.Location, tokens[0]));
     };
 
-    static ParseResult<T> ParseByTokenType<T>(
-        IEnumerable<Token> tokens,
+    /// <summary>
+    /// Creates a parser that chooses a parser based on the type of the first token.
+    /// </summary>
+    static Parser<T> ParserByTokenType<T>(
         string production,
-        IReadOnlyDictionary<TokenType, Parser<T>> parserMap,
-        int index = 0,
+        TokenTypeMap<Parser<T>> parserMap,
         Parser<T>? fallback = null
-    )
-    {
-        var keyToken = tokens.ElementAtOrNone(index);
+    ) => tokens => {
+        var keyToken = tokens.Peek();
         return keyToken.HasValue && parserMap.TryGetValue(keyToken.Value.Type, out var parser)
             ? parser(tokens)
-            : fallback?.Invoke(tokens).MapError(Error().CombineWith)
-           ?? ParseResult.Fail<T>(keyToken.Map(t => new SourceTokens(t)).ValueOr(SourceTokens.Empty), Error());
+            : fallback?.Invoke(tokens) is { } fallbackResult
+                ? fallbackResult.HasValue ? fallbackResult : fallbackResult.CombineError(tokens.Context, Error())
+                : ParseResult.Fail<T>(tokens.Context, keyToken.Map(t => new SourceTokens(t)).ValueOr(SourceTokens.Empty), Error());
 
-        ParseError Error() => ParseError.ForProduction(production, keyToken, parserMap.Keys.ToImmutableHashSet());
-    }
+        ParseError Error() => ParseError.ForProduction(production, keyToken, parserMap.Keys);
+    };
 
     static ParseResult<T> ParseByIdentifierValue<T>(
-        IEnumerable<Token> tokens,
+        TokenCursor tokens,
         string production,
         Dictionary<string, Parser<T>> parserMap,
         int index = 0,
         Parser<T>? fallback = null
     )
     {
-        var keyToken = tokens.ElementAtOrNone(index);
+        var keyToken = tokens.Peek(index);
         return keyToken.HasValue
             && keyToken.Value.Type == TokenType.Valued.Identifier
-            && parserMap.TryGetValue(keyToken.Value.Value.NotNull(), out var parser)
+            && TryGetByIdentifierValue(parserMap, keyToken.Value.Value.Span, out var parser)
             ? parser(tokens)
-            : fallback?.Invoke(tokens).MapError(Error().CombineWith)
-           ?? ParseResult.Fail<T>(SourceTokens.Empty, Error());
+            : fallback?.Invoke(tokens) is { } fallbackResult
+                ? fallbackResult.HasValue ? fallbackResult : fallbackResult.CombineError(tokens.Context, Error())
+                : ParseResult.Fail<T>(tokens.Context, SourceTokens.Empty, Error());
 
         ParseError Error() => ParseError.ForContextKeyword(production, keyToken, ImmutableHashSet.CreateRange(parserMap.Keys));
     }
 
+    // Linear search: avoids materializing the identifier, and the maps only have a handful of entries.
+    static bool TryGetByIdentifierValue<T>(Dictionary<string, Parser<T>> parserMap, ReadOnlySpan<char> value, [NotNullWhen(true)] out Parser<T>? parser)
+    {
+        foreach (var (name, p) in parserMap) {
+            if (value.SequenceEqual(name)) {
+                parser = p;
+                return true;
+            }
+        }
+        parser = null;
+        return false;
+    }
+
     /// <summary>
     /// Returns the result of the first successful parser, or the combined error of all parsers.
     /// </summary>
@@ -68,27 +104,50 @@ partial class Parser
     /// <param name="firstParser">The first parser.</param>
     /// <param name="parsers">The other parsers.</param>
     /// <returns>The result of the first successful parsers or the error of all parsers combined.</returns>
-    /// <remarks>Parsers should be ordered by decreasing length for maximum munch.</remarks>
-    static Parser<T> ParserFirst<T>(Parser<T> firstParser, params Parser<T>[] parsers) => tokens => {
-        var result = firstParser(tokens);
-        var enumParser = parsers.GetGenericEnumerator();
+    /// <remarks>
+    /// <para>Parsers should be ordered by decreasing length for maximum munch.</para>
+    /// <para>The returned parser is memoized when the parse memoizes: create it once, when building the grammar, and reuse it, so that alternatives that fail can share its results at the same position.</para>
+    /// </remarks>
+    Parser<T> ParserFirst<T>(Parser<T> firstParser, params Parser<T>[] parsers) => ParserFirst(false, firstParser, parsers);
 
-        while (!result.HasValue && enumParser.MoveNext()) {
-            result = enumParser.Current(tokens).MapError(result.Error.CombineWith);
-        }
+    /// <summary>
+    /// Returns the result of the first successful parser, or the combined error of all parsers, memoized in every parse.
+    /// </summary>
+    /// <remarks>For productions that are parsed again by their alternatives at each level of nesting, which takes exponential time without memoization.</remarks>
+    /// <inheritdoc cref="ParserFirst{T}(Parser{T}, Parser{T}[])"/>
+    Parser<T> ParserFirstMemoized<T>(Parser<T> firstParser, params Parser<T>[] parsers) => ParserFirst(true, firstParser, parsers);
 
-        return result;
-    };
+    Parser<T> ParserFirst<T>(bool alwaysMemoize, Parser<T> firstParser, Parser<T>[] parsers)
+    {
+        int memoId = _memoizedProductionCount++;
+        return tokens => {
+            var memo = tokens.Context.GetMemoTable<T>(memoId, alwaysMemoize);
+            if (memo is not null && memo.TryGetValue(tokens.Index, out var memoized)) {
+                return memoized;
+            }
+
+            var result = firstParser(tokens);
+
+            for (int i = 0; !result.HasValue && i < parsers.Length; ++i) {
+                result = parsers[i](tokens).CombineError(tokens.Context, result.Error);
+            }
+
+            if (memo is not null) {
+                memo[tokens.Index] = result;
+            }
+            return result;
+        };
+    }
 
-    static ParseResult<T> ParseToken<T>(IEnumerable<Token> tokens, TokenType expectedType, ResultCreator<T> resultCreator) => ParseOperation
+    static ParseResult<T> ParseToken<T>(TokenCursor tokens, TokenType expectedType, ResultCreator<T> resultCreator) => ParseOperation
        .Start(tokens, expectedType.ToString())
        .ParseToken(expectedType)
        .MapResult(resultCreator);
 
-    static ParseResult<T> ParseTokenValue<T>(IEnumerable<Token> tokens, TokenType expectedType, ValuedResultCreator<T> resultCreator) => ParseOperation
+    static ParseResult<T> ParseTokenValue<T>(TokenCursor tokens, TokenType expectedType, ValuedResultCreator<T> resultCreator) => ParseOperation
        .Start(tokens, expectedType.ToString())
        .ParseTokenValue(out var value, expectedType)
-       .MapResult(tokens => resultCreator(tokens, value));
+       .MapResult((resultCreator, value), static (t, s) => s.resultCreator(t, s.value));
 
     static void AddContextKeyword<T>(Dictionary<string, Parser<T>> parsers, TokenType.ContextKeyword contextKeyword, Parser<T> parser)
     {
@@ -11,33 +11,58 @@ namespace Scover.Psdc.Parsing;
 
 public sealed partial class Parser
 {
-    readonly Messenger _msger;
+    // The tokens that end lists parsed until a token.
+    static readonly TokenTypeSet
+        endLeadingDirectives = TokenTypeSet.Of(Keyword.Program),
+        endDeclarations = TokenTypeSet.Of(Eof),
+        endBlock = TokenTypeSet.Of(Keyword.End),
+        endIfBlock = TokenTypeSet.Of(Keyword.EndIf, Keyword.Else, Keyword.ElseIf),
+        endElseIfClauses = TokenTypeSet.Of(Keyword.EndIf, Keyword.Else),
+        endElseBlock = TokenTypeSet.Of(Keyword.EndIf),
+        endDoWhileBlock = TokenTypeSet.Of(Keyword.While),
+        endForBlock = TokenTypeSet.Of(Keyword.EndDo, Keyword.EndFor),
+        endRepeatBlock = TokenTypeSet.Of(Keyword.Until),
+        endCaseBlock = TokenTypeSet.Of(Keyword.When, Keyword.EndSwitch),
+        endSwitchCases = TokenTypeSet.Of(Keyword.EndSwitch),
+        endWhileBlock = TokenTypeSet.Of(Keyword.EndDo),
+        // The designators of an item end at its := token, or give up at the end of the item so that undesignated items aren't read past.
+        endDesignators = TokenTypeSet.Of(Punctuation.ColonEqual, Punctuation.Comma, Punctuation.RBrace);
+
+    // The grammar is immutable once built, so parses share it, even concurrently. Per-parse state lives in ParseContext.
+    static readonly Parser grammar = new();
+
+    // Number of memoized productions, that is, of ParserFirst parsers. Only incremented while building the grammar.
+    int _memoizedProductionCount;
     readonly Parser<Type> _type;
     readonly Parser<Declaration> _declaration;
     readonly Parser<Stmt> _statement;
     readonly Parser<CompilerDirective> _compilerDirective;
     readonly Parser<IEnumerable<Designator>> _designator;
 
-    Parser(Messenger messenger)
-    {
-        _msger = messenger;
+    readonly Parser<(Expr.Lvalue variant, Expr start, Expr end, Option<Expr> step)> _forLoopHead;
+    readonly Parser<Component> _structureComponent;
+    readonly Parser<Initializer> _initializer;
+    readonly Parser<Initializer.Braced.Item> _bracedInitializerItem;
+    readonly TokenTypeMap<Branch<Stmt.Builtin>> _builtinBranches;
 
+    Parser()
+    {
         Dictionary<string, Parser<CompilerDirective>> compilerDirectiveParsers = [];
         AddContextKeyword(compilerDirectiveParsers, ContextKeyword.Assert, HashAssert);
         AddContextKeyword(compilerDirectiveParsers, ContextKeyword.Eval, ParserFirst<CompilerDirective>(HashEvalExpr, HashEvalType));
         _compilerDirective = t => ParseByIdentifierValue(t, "compiler directive", compilerDirectiveParsers, 1);
 
-        Dictionary<TokenType, Parser<Declaration>> declarationParsers = new() {
+        TokenTypeMap<Parser<Declaration>> declarationParsers = new() {
             [Keyword.Begin] = MainProgram,
             [Keyword.Constant] = Constant,
             [Keyword.Function] = FunctionDeclarationOrDefinition,
             [Keyword.Procedure] = ProcedureDeclarationOrDefinition,
             [Keyword.Type] = TypeAlias,
-            [Punctuation.Semicolon] = Nop,
+            [Punctuation.Semicolon] = t => Nop(t).Upcast<Nop, Declaration>(),
         };
-        _declaration = t => ParseByTokenType(t, "declaration", declarationParsers, fallback: _compilerDirective);
+        _declaration = ParserByTokenType("declaration", declarationParsers, fallback: ParserUpcast<CompilerDirective, Declaration>(_compilerDirective));
 
-        Dictionary<TokenType, Parser<Stmt>> statementParsers = new() {
+        TokenTypeMap<Parser<Stmt>> statementParsers = new() {
             [Valued.Identifier] = ParserFirst(Assignment, LocalVariable, ExpressionStatement),
             [Keyword.Do] = DoWhileLoop,
             [Keyword.For] = ForLoop,
@@ -46,299 +71,380 @@ public sealed partial class Parser
             [Keyword.Return] = Return,
             [Keyword.Switch] = Switch,
             [Keyword.While] = WhileLoop,
-            [Punctuation.Semicolon] = Nop,
+            [Punctuation.Semicolon] = t => Nop(t).Upcast<Nop, Stmt>(),
         };
-        _statement = t => ParseByTokenType(t, "statement", statementParsers, fallback: ParserFirst(Builtin, ExpressionStatement, _compilerDirective));
-
-        Dictionary<TokenType, Parser<Type>> typeParsers = new() {
-            [Keyword.Integer] = ParserReturn(1, t => new Type.Integer(t)),
-            [Keyword.Real] = ParserReturn(1, t => new Type.Real(t)),
-            [Keyword.Character] = ParserReturn(1, t => new Type.Character(t)),
-            [Keyword.Boolean] = ParserReturn(1, t => new Type.Boolean(t)),
-            [Keyword.File] = ParserReturn(1, t => new Type.File(t)),
+        var statementFallback = ParserFirst(Builtin, ExpressionStatement, ParserUpcast<CompilerDirective, Stmt>(_compilerDirective));
+        _statement = ParserNested("statement", ParserByTokenType("statement", statementParsers, fallback: statementFallback));
+
+        TokenTypeMap<Parser<Type>> typeParsers = new() {
+            [Keyword.Integer] = ParserReturn<Type>(1, t => new Type.Integer(t)),
+            [Keyword.Real] = ParserReturn<Type>(1, t => new Type.Real(t)),
+            [Keyword.Character] = ParserReturn<Type>(1, t => new Type.Character(t)),
+            [Keyword.Boolean] = ParserReturn<Type>(1, t => new Type.Boolean(t)),
+            [Keyword.File] = ParserReturn<Type>(1, t => new Type.File(t)),
             [Keyword.String] = TypeString,
             [Keyword.Array] = TypeArray,
-            [Valued.Identifier] = ParserReturn1((t, val) => new Type.AliasReference(t, new(t, val))),
+            [Valued.Identifier] = ParserReturn1<Type>((t, token) => new Type.AliasReference(t, new(t, token))),
             [Keyword.Structure] = TypeStructure,
         };
-        _type = t => ParseByTokenType(t, "type", typeParsers);
+        _type = ParserNested("type", ParserByTokenType("type", typeParsers));
 
-        Dictionary<TokenType, Parser<Expr.Literal>> literalParsers = new() {
-            [Keyword.False] = t => ParseToken(t, Keyword.False, t => new Expr.Literal.False(t)),
-            [Keyword.True] = t => ParseToken(t, Keyword.True, t => new Expr.Literal.True(t)),
-            [Valued.LiteralCharacter] = t => ParseTokenValue(t, Valued.LiteralCharacter, (t, val) => {
-                var unescaped = Strings.Unescape(val, Format.Code).ToString();
+        TokenTypeMap<Parser<Expr.Literal>> literalParsers = new() {
+            [Keyword.False] = t => ParseToken<Expr.Literal>(t, Keyword.False, t => new Expr.Literal.False(t)),
+            [Keyword.True] = t => ParseToken<Expr.Literal>(t, Keyword.True, t => new Expr.Literal.True(t)),
+            [Valued.LiteralCharacter] = tokens => ParseTokenValue<Expr.Literal>(tokens, Valued.LiteralCharacter, (t, val) => {
+                var unescaped = Strings.Unescape(val.Span, Format.Code).ToString();
                 // The character literal token rule must not accept empty char literals for this to work.
                 if (unescaped.Length != 1) {
-                    _msger.Report(Message.ErrorCharacterLiteralContainsMoreThanOneCharacter(t, unescaped[0]));
+                    tokens.Context.Messenger.Report(Message.ErrorCharacterLiteralContainsMoreThanOneCharacter(t, unescaped[0]));
                 }
                 return new Expr.Literal.Character(t, unescaped[0]);
             }),
-            [Valued.LiteralInteger] = t => ParseTokenValue(t, Valued.LiteralInteger, (t, val) => new Expr.Literal.Integer(t, val)),
-            [Valued.LiteralReal] = t => ParseTokenValue(t, Valued.LiteralReal, (t, val) => new Expr.Literal.Real(t, val)),
+            [Valued.LiteralInteger] = t => ParseTokenValue<Expr.Literal>(t, Valued.LiteralInteger, (t, val) => new Expr.Literal.Integer(t, val.Span)),
+            [Valued.LiteralReal] = t => ParseTokenValue<Expr.Literal>(t, Valued.LiteralReal, (t, val) => new Expr.Literal.Real(t, val.Span)),
             [Valued.LiteralString] = t =>
-                ParseTokenValue(t, Valued.LiteralString, (t, val) => new Expr.Literal.String(t, Strings.Unescape(val, Format.Code).ToString())),
+                ParseTokenValue<Expr.Literal>(t, Valued.LiteralString, (t, val) => new Expr.Literal.String(t, Strings.Unescape(val.Span, Format.Code).ToString())),
         };
-        _literal = t => ParseByTokenType(t, "literal", literalParsers);
+        _literal = ParserByTokenType("literal", literalParsers);
 
-        Dictionary<TokenType, Parser<IEnumerable<Designator>>> designatorParsers = new() {
+        TokenTypeMap<Parser<IEnumerable<Designator>>> designatorParsers = new() {
             [Punctuation.LBracket] = ArrayDesignator, [Punctuation.Dot] = StructureDesignator,
         };
-        _designator = t => ParseByTokenType(t, "designator", designatorParsers);
+        _designator = ParserByTokenType("designator", designatorParsers);
+
+        _parseUnaryOperator = ParserFirst<UnaryOperator>(
+            t => ParseToken<UnaryOperator>(t, Punctuation.Minus, t => new UnaryOperator.Minus(t)),
+            t => ParseToken<UnaryOperator>(t, Keyword.Not, t => new UnaryOperator.Not(t)),
+            t => ParseToken<UnaryOperator>(t, Punctuation.Plus, t => new UnaryOperator.Plus(t)),
+            t => ParseOperation.Start(t, "cast operator")
+               .ParseToken(Punctuation.LParen)
+               .Parse(out var target, _type)
+               .ParseToken(Punctuation.RParen)
+               .MapResult(target, static UnaryOperator (t, target) => new UnaryOperator.Cast(t, target)));
+        _accessParsers = new() { [Punctuation.LBracket] = ArraySubscriptRight, [Punctuation.Dot] = ComponentAccessRight };
+        // Lvalues try parentheses as the seed of a subscript or component access, then alone, and each alternative parses the inner parentheses again:
+        // without memoization, each level of nesting would double the parsing time. Terminals are memoized too, since statements try them as lvalues, then in expressions.
+        _lvalueParser = ParserNested("lvalue", ParserFirstMemoized(
+            ParserBinaryAtLeast1<Expr, Expr.Lvalue>("lvalue", TerminalRvalue, _accessParsers), TerminalLvalue));
+        _terminalLvalueParser = ParserFirstMemoized(
+            t => Identifier(t)
+               .Map<Ident, Expr.Lvalue>((t, name) => new Expr.Lvalue.VariableReference(t.Location, name)),
+            ParenLvalue);
+        _terminalRvalueParser = ParserFirstMemoized(
+            ParserUpcast<Expr.Literal, Expr>(_literal),
+            Call,
+            ParserUpcast<Expr.Lvalue, Expr>(TerminalLvalue),
+            ParenExpr,
+            BuiltinFdf);
+
+        _forLoopHead = ParserFirst(ForLoopHead, ForLoopHeadParenthesized);
+        _structureComponent = ParserFirst(StructureComponent, ParserUpcast<CompilerDirective, Component>(_compilerDirective));
+        _initializer = ParserNested("initializer", ParserFirst(BracedInitializer, t => Expression(t).Upcast<Expr, Initializer>()));
+        _bracedInitializerItem = ParserFirst(BracedInitializerValuedItem, ParserUpcast<CompilerDirective, Initializer.Braced.Item>(_compilerDirective));
+        _builtinBranches = new() {
+            [Keyword.EcrireEcran]
+                = o => (o.ParseZeroOrMoreSeparated(out var arguments, Expression, Punctuation.Comma, Punctuation.RParen, readEndToken: false),
+                    t => new Stmt.Builtin.EcrireEcran(t, ReportErrors(o.Context, arguments))),
+            [Keyword.LireClavier] = o => (o.Parse(out var argVariable, ParseLvalue), t => new Stmt.Builtin.LireClavier(t, argVariable)),
+            [Keyword.Lire]
+                = o => (o.Parse(out var argNomLog, Expression).ParseToken(Punctuation.Comma).Parse(out var argVariable, ParseLvalue),
+                    t => new Stmt.Builtin.Lire(t, argNomLog, argVariable)),
+            [Keyword.Ecrire]
+                = o => (o.Parse(out var argNomLog, Expression).ParseToken(Punctuation.Comma).Parse(out var argExpr, Expression),
+                    t => new Stmt.Builtin.Ecrire(t, argNomLog, argExpr)),
+            [Keyword.OuvrirAjout] = o => (o.Parse(out var argNomLog, Expression), t => new Stmt.Builtin.OuvrirAjout(t, argNomLog)),
+            [Keyword.OuvrirEcriture] = o => (o.Parse(out var argNomLog, Expression), t => new Stmt.Builtin.OuvrirEcriture(t, argNomLog)),
+            [Keyword.OuvrirLecture] = o => (o.Parse(out var argNomLog, Expression), t => new Stmt.Builtin.OuvrirLecture(t, argNomLog)),
+            [Keyword.Fermer] = o => (o.Parse(out var argNomLog, Expression), t => new Stmt.Builtin.Fermer(t, argNomLog)),
+            [Keyword.Assigner]
+                = o => (o.Parse(out var argNomLog, ParseLvalue).ParseToken(Punctuation.Comma).Parse(out var argNomExt, Expression),
+                    t => new Stmt.Builtin.Assigner(t, argNomLog, argNomExt)),
+        };
     }
 
+    /// <summary>
+    /// The default maximum nesting depth of expressions, statements, types and initializers.
+    /// </summary>
+    /// <remarks>Blocks, braced initializers, parenthesized lvalues and the expressions in calls and subscripts count as levels. Parentheses and operators in expressions don't, since they are parsed and compiled without recursing.</remarks>
+    public const int DefaultMaxNestingDepth = 1000;
+
     // Parsing starts here with the "Algorithm" production rule
-    public static ValueOption<Algorithm> Parse(Messenger messenger, IEnumerable<Token> tokens)
+    /// <summary>
+    /// Parses an algorithm.
+    /// </summary>
+    /// <param name="messenger">The messenger to report syntax errors to.</param>
+    /// <param name="tokens">The tokens of the algorithm.</param>
+    /// <param name="memoize">Whether to memoize the results of all backtracking productions, so that they are parsed at most once per token. Lvalues and terminal expressions are always memoized; memoizing the other productions only pays off on input that backtracks heavily.</param>
+    /// <param name="maxNestingDepth">The maximum nesting depth of expressions, statements, types and initializers. Deeper input fails to parse with an error.</param>
+    /// <returns>The syntax tree, or none if the algorithm could not be parsed.</returns>
+    public static ValueOption<Algorithm> Parse(Messenger messenger, Token[] tokens, bool memoize = false, int maxNestingDepth = DefaultMaxNestingDepth)
     {
-        Parser p = new(messenger);
-        var algorithm = p.Algorithm(tokens);
-
-        // Don't report an error the errenous token is EOF (which means the tokens stream was empty)
-        if (!algorithm.HasValue && algorithm.Error.ErroneousToken.Map(t => t.Type != Eof).ValueOr(true)) {
-            messenger.Report(Message.ErrorSyntax(algorithm.SourceTokens.Location, algorithm.Error));
+        ParseContext context = new(tokens, messenger, memoize, grammar._memoizedProductionCount, maxNestingDepth);
+        try {
+            var algorithm = grammar.Algorithm(new(context));
+
+            // Other syntax errors are consequences of the nesting error, which has been reported.
+            if (context.NestingLimitExceeded) {
+                return default;
+            }
+
+            // Don't report an error the errenous token is EOF (which means the tokens stream was empty)
+            if (!algorithm.HasValue && algorithm.Error.ErroneousToken.Map(t => t.Type != Eof).ValueOr(true)) {
+                messenger.Report(Message.ErrorSyntax(algorithm.SourceTokens.Location, algorithm.Error));
+            }
+
+            return algorithm.DropError();
+        } finally {
+            context.End();
         }
-
-        return algorithm.DropError();
     }
 
-    ParseResult<Algorithm> Algorithm(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "algorithm")
-       .ParseZeroOrMoreUntilToken(out var leadingDirectives, _compilerDirective, Set.Of<TokenType>(Keyword.Program)).ParseToken(Keyword.Program)
-       .Parse(out var name, Identifier).ParseToken(Keyword.Is).ParseZeroOrMoreUntilToken(out var declarations, _declaration, Set.Of(Eof))
-       .MapResult(t => new Algorithm(t, ReportErrors(leadingDirectives), name, ReportErrors(declarations)));
+    ParseResult<Algorithm> Algorithm(TokenCursor tokens) => ParseOperation.Start(tokens, "algorithm")
+       .ParseZeroOrMoreUntilToken(out var leadingDirectives, _compilerDirective, endLeadingDirectives).ParseToken(Keyword.Program)
+       .Parse(out var name, Identifier).ParseToken(Keyword.Is).ParseZeroOrMoreUntilToken(out var declarations, _declaration, endDeclarations)
+       .MapResult((tokens.Context, leadingDirectives, name, declarations),
+            static (t, s) => new Algorithm(t, ReportErrors(s.Context, s.leadingDirectives), s.name, ReportErrors(s.Context, s.declarations)));
 
     #region Declarations
 
-    ParseResult<Declaration.TypeAlias> TypeAlias(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "type alias").ParseToken(Keyword.Type)
+    ParseResult<Declaration> TypeAlias(TokenCursor tokens) => ParseOperation.Start(tokens, "type alias").ParseToken(Keyword.Type)
        .Parse(out var name, Identifier).ParseToken(Punctuation.Equal).Parse(out var type, _type).ParseToken(Punctuation.Semicolon)
-       .MapResult(t => new Declaration.TypeAlias(t, name, type));
+       .MapResult((name, type), static Declaration (t, s) => new Declaration.TypeAlias(t, s.name, s.type));
 
-    ParseResult<Declaration.Constant> Constant(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "constant").ParseToken(Keyword.Constant)
+    ParseResult<Declaration> Constant(TokenCursor tokens) => ParseOperation.Start(tokens, "constant").ParseToken(Keyword.Constant)
        .Parse(out var type, _type).Parse(out var name, Identifier).ParseToken(Punctuation.ColonEqual).Parse(out var value, Initializer)
-       .ParseToken(Punctuation.Semicolon).MapResult(t => new Declaration.Constant(t, type, name, value));
+       .ParseToken(Punctuation.Semicolon).MapResult((type, name, value), static Declaration (t, s) => new Declaration.Constant(t, s.type, s.name, s.value));
 
-    ParseResult<Declaration> FunctionDeclarationOrDefinition(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "function").ParseToken(Keyword.Function)
+    ParseResult<Declaration> FunctionDeclarationOrDefinition(TokenCursor tokens) => ParseOperation.Start(tokens, "function").ParseToken(Keyword.Function)
        .Parse(out var name, Identifier).ParseToken(Punctuation.LParen)
        .ParseZeroOrMoreSeparated(out var parameters, ParameterFormal, Punctuation.Comma, Punctuation.RParen).ParseToken(Keyword.Delivers)
-       .Parse(out var returnType, _type).Get(out var signature, t => new FunctionSignature(t, name, ReportErrors(parameters), returnType)).Switch<Declaration>(
+       .Parse(out var returnType, _type).Get(out var signature, (tokens.Context, name, parameters, returnType),
+            static (t, s) => new FunctionSignature(t, s.name, ReportErrors(s.Context, s.parameters), s.returnType)).Switch<Declaration>(
             out var branch,
             new() {
                 [Punctuation.Semicolon] = o => (o, t => new Declaration.Function(t, signature)),
                 [Keyword.Is]
                     = o => (
-                        o.ParseToken(Keyword.Begin).ParseZeroOrMoreUntilToken(out var block, _statement, Set.Of<TokenType>(Keyword.End))
-                           .ParseToken(Keyword.End), t => new Declaration.FunctionDefinition(t, signature, ReportErrors(block))),
-                [Keyword.Begin] = o => (o.ParseZeroOrMoreUntilToken(out var block, _statement, Set.Of<TokenType>(Keyword.End)).ParseToken(Keyword.End),
-                    t => new Declaration.FunctionDefinition(t, signature, ReportErrors(block))),
+                        o.ParseToken(Keyword.Begin).ParseZeroOrMoreUntilToken(out var block, _statement, endBlock)
+                           .ParseToken(Keyword.End), t => new Declaration.FunctionDefinition(t, signature, ReportErrors(tokens.Context, block))),
+                [Keyword.Begin] = o => (o.ParseZeroOrMoreUntilToken(out var block, _statement, endBlock).ParseToken(Keyword.End),
+                    t => new Declaration.FunctionDefinition(t, signature, ReportErrors(tokens.Context, block))),
             }).Fork(out var result, branch).MapResult(result);
 
-    ParseResult<Declaration.MainProgram> MainProgram(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "main program").ParseToken(Keyword.Begin)
-       .ParseZeroOrMoreUntilToken(out var block, _statement, Set.Of<TokenType>(Keyword.End)).ParseToken(Keyword.End)
-       .MapResult(t => new Declaration.MainProgram(t, ReportErrors(block)));
+    ParseResult<Declaration> MainProgram(TokenCursor tokens) => ParseOperation.Start(tokens, "main program").ParseToken(Keyword.Begin)
+       .ParseZeroOrMoreUntilToken(out var block, _statement, endBlock).ParseToken(Keyword.End)
+       .MapResult((tokens.Context, block), static Declaration (t, s) => new Declaration.MainProgram(t, ReportErrors(s.Context, s.block)));
 
-    ParseResult<Declaration> ProcedureDeclarationOrDefinition(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "procedure")
+    ParseResult<Declaration> ProcedureDeclarationOrDefinition(TokenCursor tokens) => ParseOperation.Start(tokens, "procedure")
        .ParseToken(Keyword.Procedure).Parse(out var name, Identifier).ParseToken(Punctuation.LParen)
        .ParseZeroOrMoreSeparated(out var parameters, ParameterFormal, Punctuation.Comma, Punctuation.RParen)
-       .Get(out var signature, t => new ProcedureSignature(t, name, ReportErrors(parameters))).Switch<Declaration>(out var branch,
+       .Get(out var signature, (tokens.Context, name, parameters), static (t, s) => new ProcedureSignature(t, s.name, ReportErrors(s.Context, s.parameters)))
+       .Switch<Declaration>(out var branch,
             new() {
                 [Punctuation.Semicolon] = o => (o, t => new Declaration.Procedure(t, signature)),
                 [Keyword.Is]
                     = o => (
-                        o.ParseToken(Keyword.Begin).ParseZeroOrMoreUntilToken(out var block, _statement, Set.Of<TokenType>(Keyword.End))
-                           .ParseToken(Keyword.End), t => new Declaration.ProcedureDefinition(t, signature, ReportErrors(block))),
-                [Keyword.Begin] = o => (o.ParseZeroOrMoreUntilToken(out var block, _statement, Set.Of<TokenType>(Keyword.End)).ParseToken(Keyword.End),
-                    t => new Declaration.ProcedureDefinition(t, signature, ReportErrors(block))),
+                        o.ParseToken(Keyword.Begin).ParseZeroOrMoreUntilToken(out var block, _statement, endBlock)
+                           .ParseToken(Keyword.End), t => new Declaration.ProcedureDefinition(t, signature, ReportErrors(tokens.Context, block))),
+                [Keyword.Begin] = o => (o.ParseZeroOrMoreUntilToken(out var block, _statement, endBlock).ParseToken(Keyword.End),
+                    t => new Declaration.ProcedureDefinition(t, signature, ReportErrors(tokens.Context, block))),
             }).Fork(out var result, branch).MapResult(result);
 
     #endregion Declarations
 
     #region Statements
 
-    ParseResult<Stmt> ExpressionStatement(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "expression statement").Parse(out var expr, Expression)
-       .ParseToken(Punctuation.Semicolon).MapResult(t => new Stmt.ExprStmt(t, expr));
+    ParseResult<Stmt> ExpressionStatement(TokenCursor tokens) => ParseOperation.Start(tokens, "expression statement").Parse(out var expr, Expression)
+       .ParseToken(Punctuation.Semicolon).MapResult(expr, static Stmt (t, expr) => new Stmt.ExprStmt(t, expr));
 
-    ParseResult<Stmt> Alternative(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "alternative").ParseToken(Keyword.If)
+    ParseResult<Stmt> Alternative(TokenCursor tokens) => ParseOperation.Start(tokens, "alternative").ParseToken(Keyword.If)
        .Parse(out var ifCondition, Expression).ParseToken(Keyword.Then)
-       .ParseZeroOrMoreUntilToken(out var ifBlock, _statement, Set.Of<TokenType>(Keyword.EndIf, Keyword.Else, Keyword.ElseIf))
-       .Get(out var ifClause, t => new Stmt.Alternative.IfClause(t, ifCondition, ReportErrors(ifBlock)))
+       .ParseZeroOrMoreUntilToken(out var ifBlock, _statement, endIfBlock)
+       .Get(out var ifClause, (tokens.Context, ifCondition, ifBlock),
+            static (t, s) => new Stmt.Alternative.IfClause(t, s.ifCondition, ReportErrors(s.Context, s.ifBlock)))
        .ParseZeroOrMoreUntilToken(out var elseIfClauses,
             tokens => ParseOperation.Start(tokens, "alternative sinonsi").ParseToken(Keyword.ElseIf).Parse(out var condition, Expression)
-               .ParseToken(Keyword.Then).ParseZeroOrMoreUntilToken(out var block, _statement, Set.Of<TokenType>(Keyword.EndIf, Keyword.Else, Keyword.ElseIf))
-               .MapResult(t => new Stmt.Alternative.ElseIfClause(t, condition, ReportErrors(block))), Set.Of<TokenType>(Keyword.EndIf, Keyword.Else))
+               .ParseToken(Keyword.Then).ParseZeroOrMoreUntilToken(out var block, _statement, endIfBlock)
+               .MapResult((tokens.Context, condition, block),
+                    static (t, s) => new Stmt.Alternative.ElseIfClause(t, s.condition, ReportErrors(s.Context, s.block))), endElseIfClauses)
        .ParseOptional(out var elseClause,
             tokens => ParseOperation.Start(tokens, "alternative sinon").ParseToken(Keyword.Else)
-               .ParseZeroOrMoreUntilToken(out var elseBlock, _statement, Set.Of<TokenType>(Keyword.EndIf))
-               .MapResult(t => new Stmt.Alternative.ElseClause(t, ReportErrors(elseBlock)))).ParseToken(Keyword.EndIf)
-       .MapResult(t => new Stmt.Alternative(t, ifClause, ReportErrors(elseIfClauses), elseClause));
+               .ParseZeroOrMoreUntilToken(out var elseBlock, _statement, endElseBlock)
+               .MapResult((tokens.Context, elseBlock), static (t, s) => new Stmt.Alternative.ElseClause(t, ReportErrors(s.Context, s.elseBlock))))
+       .ParseToken(Keyword.EndIf)
+       .MapResult((tokens.Context, ifClause, elseIfClauses, elseClause),
+            static Stmt (t, s) => new Stmt.Alternative(t, s.ifClause, ReportErrors(s.Context, s.elseIfClauses), s.elseClause));
 
-    ParseResult<Stmt> Assignment(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "assignment").Parse(out var target, ParseLvalue)
+    ParseResult<Stmt> Assignment(TokenCursor tokens) => ParseOperation.Start(tokens, "assignment").Parse(out var target, ParseLvalue)
        .ParseToken(Punctuation.ColonEqual).Parse(out var value, Expression).ParseToken(Punctuation.Semicolon)
-       .MapResult(t => new Stmt.Assignment(t, target, value));
+       .MapResult((target, value), static Stmt (t, s) => new Stmt.Assignment(t, s.target, s.value));
 
-    ParseResult<Stmt> Builtin(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "builtin procedure call").Switch<Stmt.Builtin>(out var branch,
-        new() {
-            [Keyword.EcrireEcran]
-                = o => (o.ParseZeroOrMoreSeparated(out var arguments, Expression, Punctuation.Comma, Punctuation.RParen, readEndToken: false),
-                    t => new Stmt.Builtin.EcrireEcran(t, ReportErrors(arguments))),
-            [Keyword.LireClavier] = o => (o.Parse(out var argVariable, ParseLvalue), t => new Stmt.Builtin.LireClavier(t, argVariable)),
-            [Keyword.Lire]
-                = o => (o.Parse(out var argNomLog, Expression).ParseToken(Punctuation.Comma).Parse(out var argVariable, ParseLvalue),
-                    t => new Stmt.Builtin.Lire(t, argNomLog, argVariable)),
-            [Keyword.Ecrire]
-                = o => (o.Parse(out var argNomLog, Expression).ParseToken(Punctuation.Comma).Parse(out var argExpr, Expression),
-                    t => new Stmt.Builtin.Ecrire(t, argNomLog, argExpr)),
-            [Keyword.OuvrirAjout] = o => (o.Parse(out var argNomLog, Expression), t => new Stmt.Builtin.OuvrirAjout(t, argNomLog)),
-            [Keyword.OuvrirEcriture] = o => (o.Parse(out var argNomLog, Expression), t => new Stmt.Builtin.OuvrirEcriture(t, argNomLog)),
-            [Keyword.OuvrirLecture] = o => (o.Parse(out var argNomLog, Expression), t => new Stmt.Builtin.OuvrirLecture(t, argNomLog)),
-            [Keyword.Fermer] = o => (o.Parse(out var argNomLog, Expression), t => new Stmt.Builtin.Fermer(t, argNomLog)),
-            [Keyword.Assigner]
-                = o => (o.Parse(out var argNomLog, ParseLvalue).ParseToken(Punctuation.Comma).Parse(out var argNomExt, Expression),
-                    t => new Stmt.Builtin.Assigner(t, argNomLog, argNomExt)),
-        }).ParseToken(Punctuation.LParen).Fork(out var result, branch).ParseToken(Punctuation.RParen).ParseToken(Punctuation.Semicolon).MapResult(result);
+    ParseResult<Stmt> Builtin(TokenCursor tokens) => ParseOperation.Start(tokens, "builtin procedure call").Switch(out var branch, _builtinBranches)
+       .ParseToken(Punctuation.LParen).Fork(out var result, branch).ParseToken(Punctuation.RParen).ParseToken(Punctuation.Semicolon).MapResult<Stmt>(result);
 
-    ParseResult<Stmt> DoWhileLoop(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "do ... while loop").ParseToken(Keyword.Do)
-       .ParseZeroOrMoreUntilToken(out var block, _statement, Set.Of<TokenType>(Keyword.While)).ParseToken(Keyword.While)
-       .ParseContextKeyword(ContextKeyword.That).Parse(out var condition, Expression).MapResult(t => new Stmt.DoWhileLoop(t, condition, ReportErrors(block)));
+    ParseResult<Stmt> DoWhileLoop(TokenCursor tokens) => ParseOperation.Start(tokens, "do ... while loop").ParseToken(Keyword.Do)
+       .ParseZeroOrMoreUntilToken(out var block, _statement, endDoWhileBlock).ParseToken(Keyword.While)
+       .ParseContextKeyword(ContextKeyword.That).Parse(out var condition, Expression)
+       .MapResult((tokens.Context, condition, block), static Stmt (t, s) => new Stmt.DoWhileLoop(t, s.condition, ReportErrors(s.Context, s.block)));
 
-    ParseResult<Stmt> ForLoop(IEnumerable<Token> tokens)
-    {
-        var endTokens = Set.Of<TokenType>(Keyword.EndDo, Keyword.EndFor);
-        return ParseOperation.Start(tokens, "for loop").ParseToken(Keyword.For).Parse(out var head,
-                ParserFirst(
-                    t => ParseOperation.Start(t, "for loop").Parse(out var variant, ParseLvalue).ParseContextKeyword(ContextKeyword.From)
-                       .Parse(out var start, Expression).ParseContextKeyword(ContextKeyword.To).Parse(out var end, Expression)
-                       .ParseOptional(out var step,
-                            t => ParseOperation.Start(t, "for loop step").ParseContextKeyword(ContextKeyword.Step).Parse(out var step, Expression)
-                               .MapResult(_ => step)).MapResult(_ => (variant, start, end, step)),
-                    t => ParseOperation.Start(t, "for loop").ParseToken(Punctuation.LParen).Parse(out var variant, ParseLvalue)
-                       .ParseContextKeyword(ContextKeyword.From).Parse(out var start, Expression).ParseContextKeyword(ContextKeyword.To)
-                       .Parse(out var end, Expression)
-                       .ParseOptional(out var step,
-                            t => ParseOperation.Start(t, "for loop step").ParseContextKeyword(ContextKeyword.Step).Parse(out var step, Expression)
-                               .MapResult(_ => step)).ParseToken(Punctuation.RParen).MapResult(_ => (variant, start, end, step)))).ParseToken(Keyword.Do)
-           .ParseZeroOrMoreUntilToken(out var block, _statement, endTokens).ParseToken(endTokens)
-           .MapResult(t => new Stmt.ForLoop(t, head.variant, head.start, head.end, head.step, ReportErrors(block)));
-    }
+    ParseResult<Stmt> ForLoop(TokenCursor tokens) => ParseOperation.Start(tokens, "for loop").ParseToken(Keyword.For).Parse(out var head, _forLoopHead)
+       .ParseToken(Keyword.Do).ParseZeroOrMoreUntilToken(out var block, _statement, endForBlock).ParseToken(endForBlock)
+       .MapResult((tokens.Context, head, block),
+            static Stmt (t, s) => new Stmt.ForLoop(t, s.head.variant, s.head.start, s.head.end, s.head.step, ReportErrors(s.Context, s.block)));
 
-    ParseResult<Nop> Nop(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "procedure").ParseToken(Punctuation.Semicolon).MapResult(t => new Nop(t));
+    ParseResult<(Expr.Lvalue variant, Expr start, Expr end, Option<Expr> step)> ForLoopHead(TokenCursor tokens) => ParseOperation.Start(tokens, "for loop")
+       .Parse(out var variant, ParseLvalue).ParseContextKeyword(ContextKeyword.From).Parse(out var start, Expression)
+       .ParseContextKeyword(ContextKeyword.To).Parse(out var end, Expression).ParseOptional(out var step, ForLoopStep)
+       .MapResult((variant, start, end, step), static (_, head) => head);
 
-    ParseResult<Stmt> RepeatLoop(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "repeat loop").ParseToken(Keyword.Repeat)
-       .ParseZeroOrMoreUntilToken(out var block, _statement, Set.Of<TokenType>(Keyword.Until)).ParseToken(Keyword.Until).Parse(out var condition, Expression)
-       .MapResult(t => new Stmt.RepeatLoop(t, condition, ReportErrors(block)));
+    ParseResult<(Expr.Lvalue variant, Expr start, Expr end, Option<Expr> step)> ForLoopHeadParenthesized(TokenCursor tokens) => ParseOperation
+       .Start(tokens, "for loop").ParseToken(Punctuation.LParen).Parse(out var variant, ParseLvalue).ParseContextKeyword(ContextKeyword.From)
+       .Parse(out var start, Expression).ParseContextKeyword(ContextKeyword.To).Parse(out var end, Expression).ParseOptional(out var step, ForLoopStep)
+       .ParseToken(Punctuation.RParen).MapResult((variant, start, end, step), static (_, head) => head);
 
-    ParseResult<Stmt> Return(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "return statement").ParseToken(Keyword.Return)
-       .ParseOptional(out var returnValue, Expression).ParseToken(Punctuation.Semicolon).MapResult(t => new Stmt.Return(t, returnValue));
+    ParseResult<Expr> ForLoopStep(TokenCursor tokens) => ParseOperation.Start(tokens, "for loop step").ParseContextKeyword(ContextKeyword.Step)
+       .Parse(out var step, Expression).MapResult(step, static (_, step) => step);
 
-    ParseResult<Stmt> LocalVariable(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "local variable declaration")
+    ParseResult<Nop> Nop(TokenCursor tokens) => ParseOperation.Start(tokens, "procedure").ParseToken(Punctuation.Semicolon).MapResult(t => new Nop(t));
+
+    ParseResult<Stmt> RepeatLoop(TokenCursor tokens) => ParseOperation.Start(tokens, "repeat loop").ParseToken(Keyword.Repeat)
+       .ParseZeroOrMoreUntilToken(out var block, _statement, endRepeatBlock).ParseToken(Keyword.Until).Parse(out var condition, Expression)
+       .MapResult((tokens.Context, condition, block), static Stmt (t, s) => new Stmt.RepeatLoop(t, s.condition, ReportErrors(s.Context, s.block)));
+
+    ParseResult<Stmt> Return(TokenCursor tokens) => ParseOperation.Start(tokens, "return statement").ParseToken(Keyword.Return)
+       .ParseOptional(out var returnValue, Expression).ParseToken(Punctuation.Semicolon)
+       .MapResult(returnValue, static Stmt (t, returnValue) => new Stmt.Return(t, returnValue));
+
+    ParseResult<Stmt> LocalVariable(TokenCursor tokens) => ParseOperation.Start(tokens, "local variable declaration")
        .Parse(out var declaration, t => VariableDeclaration(t, "local variable declaration"))
        .ParseOptional(out var init,
-            t => ParseOperation.Start(t, "local variable initializer").ParseToken(Punctuation.ColonEqual).Parse(out var init, Initializer).MapResult(_ => init))
-       .ParseToken(Punctuation.Semicolon).MapResult(t => new Stmt.LocalVariable(t, declaration, init));
+            t => ParseOperation.Start(t, "local variable initializer").ParseToken(Punctuation.ColonEqual).Parse(out var init, Initializer)
+               .MapResult(init, static (_, init) => init))
+       .ParseToken(Punctuation.Semicolon).MapResult((declaration, init), static Stmt (t, s) => new Stmt.LocalVariable(t, s.declaration, s.init));
 
-    ParseResult<Stmt> Switch(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "switch statement").ParseToken(Keyword.Switch)
+    ParseResult<Stmt> Switch(TokenCursor tokens) => ParseOperation.Start(tokens, "switch statement").ParseToken(Keyword.Switch)
        .Parse(out var expression, Expression).ParseToken(Keyword.Is).ParseOneOrMoreUntilToken(out var cases,
             t => ParseOperation.Start(t, "switch case").ParseToken(Keyword.When).Parse(out var when, Expression).ParseToken(Punctuation.Arrow)
-               .ParseZeroOrMoreUntilToken(out var block, _statement, Set.Of<TokenType>(Keyword.When, Keyword.EndSwitch))
-               .MapResult<Stmt.Switch.Case>(t => when is Expr.Lvalue.VariableReference { Name.Name: "autre" }
-                    ? new Stmt.Switch.Case.Default(t, ReportErrors(block))
-                    : new Stmt.Switch.Case.OfValue(t, when, ReportErrors(block))), Set.Of<TokenType>(Keyword.EndSwitch)).ParseToken(Keyword.EndSwitch)
-       .MapResult(t => new Stmt.Switch(t, expression, ReportErrors(cases)));
+               .ParseZeroOrMoreUntilToken(out var block, _statement, endCaseBlock)
+               .MapResult((t.Context, when, block), static Stmt.Switch.Case (t, s) => s.when is Expr.Lvalue.VariableReference { Name.Name: "autre" }
+                    ? new Stmt.Switch.Case.Default(t, ReportErrors(s.Context, s.block))
+                    : new Stmt.Switch.Case.OfValue(t, s.when, ReportErrors(s.Context, s.block))), endSwitchCases).ParseToken(Keyword.EndSwitch)
+       .MapResult((tokens.Context, expression, cases), static Stmt (t, s) => new Stmt.Switch(t, s.expression, ReportErrors(s.Context, s.cases)));
 
-    ParseResult<Stmt> WhileLoop(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "while loop").ParseToken(Keyword.While)
+    ParseResult<Stmt> WhileLoop(TokenCursor tokens) => ParseOperation.Start(tokens, "while loop").ParseToken(Keyword.While)
        .ParseContextKeyword(ContextKeyword.That).Parse(out var condition, Expression).ParseToken(Keyword.Do)
-       .ParseZeroOrMoreUntilToken(out var block, _statement, Set.Of<TokenType>(Keyword.EndDo)).ParseToken(Keyword.EndDo)
-       .MapResult(t => new Stmt.WhileLoop(t, condition, ReportErrors(block)));
+       .ParseZeroOrMoreUntilToken(out var block, _statement, endWhileBlock).ParseToken(Keyword.EndDo)
+       .MapResult((tokens.Context, condition, block), static Stmt (t, s) => new Stmt.WhileLoop(t, s.condition, ReportErrors(s.Context, s.block)));
 
     #endregion Statements
 
     #region Types
 
-    ParseResult<Type> TypeArray(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "array type").ParseToken(Keyword.Array)
+    ParseResult<Type> TypeArray(TokenCursor tokens) => ParseOperation.Start(tokens, "array type").ParseToken(Keyword.Array)
        .ParseToken(Punctuation.LBracket).ParseOneOrMoreSeparated(out var dimensions, Expression, Punctuation.Comma, Punctuation.RBracket)
-       .ParseContextKeyword(ContextKeyword.From).Parse(out var type, _type).MapResult(t => new Type.Array(t, type, ReportErrors(dimensions)));
+       .ParseContextKeyword(ContextKeyword.From).Parse(out var type, _type)
+       .MapResult((tokens.Context, type, dimensions), static Type (t, s) => new Type.Array(t, s.type, ReportErrors(s.Context, s.dimensions)));
 
-    ParseResult<Type> TypeString(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "string type").ParseToken(Keyword.String)
+    ParseResult<Type> TypeString(TokenCursor tokens) => ParseOperation.Start(tokens, "string type").ParseToken(Keyword.String)
        .Switch<Type>(out var branch,
             new() {
                 [Punctuation.LParen] = o => (o.Parse(out var length, Expression).ParseToken(Punctuation.RParen), t => new Type.LengthedString(t, length)),
             }, o => (o, t => new Type.String(t))).Fork(out var result, branch).MapResult(result);
 
-    ParseResult<Type> TypeStructure(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "structure type").ParseToken(Keyword.Structure)
-       .ParseToken(Keyword.Begin).ParseZeroOrMoreUntilToken(out var varDecls, ParserFirst<Component>(t => {
-            const string Prod = "structure component";
-            return ParseOperation.Start(t, Prod).Parse(out var varDecl, t => VariableDeclaration(t, Prod)).ParseToken(Punctuation.Semicolon)
-               .MapResult(_ => varDecl);
-        }, _compilerDirective), Set.Of<TokenType>(Keyword.End)).ParseToken(Keyword.End).MapResult(t => new Type.Structure(t, ReportErrors(varDecls)));
+    ParseResult<Type> TypeStructure(TokenCursor tokens) => ParseOperation.Start(tokens, "structure type").ParseToken(Keyword.Structure)
+       .ParseToken(Keyword.Begin).ParseZeroOrMoreUntilToken(out var varDecls, _structureComponent, endBlock).ParseToken(Keyword.End)
+       .MapResult((tokens.Context, varDecls), static Type (t, s) => new Type.Structure(t, ReportErrors(s.Context, s.varDecls)));
+
+    ParseResult<Component> StructureComponent(TokenCursor tokens)
+    {
+        const string Prod = "structure component";
+        return ParseOperation.Start(tokens, Prod).Parse(out var varDecl, t => VariableDeclaration(t, Prod)).ParseToken(Punctuation.Semicolon)
+           .MapResult(varDecl, static Component (_, varDecl) => varDecl);
+    }
 
     #endregion Types
 
     #region Other
 
-    ParseResult<ParameterActual> ParameterActual(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "actual parameter")
+    ParseResult<ParameterActual> ParameterActual(TokenCursor tokens) => ParseOperation.Start(tokens, "actual parameter")
        .Parse(out var mode, t => GetByTokenType(t, "actual parameter mode", parameterActualModes)).Parse(out var value, Expression)
-       .MapResult(t => new ParameterActual(t, mode, value));
+       .MapResult((mode, value), static (t, s) => new ParameterActual(t, s.mode, s.value));
 
-    ParseResult<ParameterFormal> ParameterFormal(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "formal parameter")
+    ParseResult<ParameterFormal> ParameterFormal(TokenCursor tokens) => ParseOperation.Start(tokens, "formal parameter")
        .Parse(out var mode, t => GetByTokenType(t, "formal parameter mode", parameterFormalModes)).Parse(out var name, Identifier).ParseToken(Punctuation.Colon)
-       .Parse(out var type, _type).MapResult(t => new ParameterFormal(t, mode, name, type));
-
-    ParseResult<Initializer> Initializer(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "initializer")
-       .Parse(out var init, ParserFirst(BracedInitializer, Expression)).MapResult(_ => init);
-
-    ParseResult<Initializer> BracedInitializer(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "braced initializer").ParseToken(Punctuation.LBrace)
-       .ParseZeroOrMoreSeparated(out var values,
-            ParserFirst<Initializer.Braced.Item>(
-                tokens => ParseOperation.Start(tokens, "braced initializer item")
-                   .ParseOptional(out var designators,
-                        t => ParseOperation.Start(t, "designators")
-                           .ParseZeroOrMoreUntilToken(out var des, _designator, Set.Of<TokenType>(Punctuation.ColonEqual)).ParseToken(Punctuation.ColonEqual)
-                           .MapResult(_ => des)).Parse(out var init, Initializer)
-                   .MapResult(t => new Initializer.Braced.ValuedItem(t, designators.Match(des => ReportErrors(des).SelectMany(d => d).ToArray(), () => []),
-                        init)), _compilerDirective), Punctuation.Comma, Punctuation.RBrace).MapResult(t => new Initializer.Braced(t, ReportErrors(values)));
-
-    ParseResult<IEnumerable<Designator.Array>> ArrayDesignator(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "array designator")
+       .Parse(out var type, _type).MapResult((mode, name, type), static (t, s) => new ParameterFormal(t, s.mode, s.name, s.type));
+
+    ParseResult<Initializer> Initializer(TokenCursor tokens) => ParseOperation.Start(tokens, "initializer")
+       .Parse(out var init, _initializer).MapResult(init, static (_, init) => init);
+
+    ParseResult<Initializer> BracedInitializer(TokenCursor tokens) => ParseOperation.Start(tokens, "braced initializer").ParseToken(Punctuation.LBrace)
+       .ParseZeroOrMoreSeparated(out var values, _bracedInitializerItem, Punctuation.Comma, Punctuation.RBrace)
+       .MapResult((tokens.Context, values), static Initializer (t, s) => new Initializer.Braced(t, ReportErrors(s.Context, s.values)));
+
+    ParseResult<Initializer.Braced.Item> BracedInitializerValuedItem(TokenCursor tokens) => ParseOperation.Start(tokens, "braced initializer item")
+       .ParseOptional(out var designators,
+            t => ParseOperation.Start(t, "designators")
+               .ParseZeroOrMoreUntilToken(out var des, _designator, endDesignators).ParseToken(Punctuation.ColonEqual)
+               .MapResult(des, static (_, des) => des)).Parse(out var init, Initializer)
+       .MapResult((tokens.Context, designators, init), static Initializer.Braced.Item (t, s) => new Initializer.Braced.ValuedItem(t,
+            s.designators.Match(des => ReportErrors(s.Context, des).SelectMany(d => d).ToArray(), () => []), s.init));
+
+    ParseResult<IEnumerable<Designator>> ArrayDesignator(TokenCursor tokens) => ParseOperation.Start(tokens, "array designator")
        .ParseToken(Punctuation.LBracket).ParseOneOrMoreSeparated(out var indexes, Expression, Punctuation.Comma, Punctuation.RBracket)
-       .MapResult(_ => ReportErrors(indexes).Select(i => new Designator.Array(i.Location, i)));
+       .MapResult((tokens.Context, indexes),
+            static IEnumerable<Designator> (_, s) => ReportErrors(s.Context, s.indexes).Select(i => new Designator.Array(i.Location, i)));
 
-    ParseResult<IEnumerable<Designator.Structure>> StructureDesignator(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "structure designator")
-       .ParseToken(Punctuation.Dot).Parse(out var component, Identifier).MapResult(t => new Designator.Structure(t, component).Yield());
+    ParseResult<IEnumerable<Designator>> StructureDesignator(TokenCursor tokens) => ParseOperation.Start(tokens, "structure designator")
+       .ParseToken(Punctuation.Dot).Parse(out var component, Identifier)
+       .MapResult(component, static IEnumerable<Designator> (t, component) => new Designator.Structure(t, component).Yield());
 
-    ParseResult<VariableDeclaration> VariableDeclaration(IEnumerable<Token> tokens, string production) => ParseOperation.Start(tokens, production)
+    ParseResult<VariableDeclaration> VariableDeclaration(TokenCursor tokens, string production) => ParseOperation.Start(tokens, production)
        .ParseOneOrMoreSeparated(out var names, Identifier, Punctuation.Comma, Punctuation.Colon).Parse(out var type, _type)
-       .MapResult(t => new VariableDeclaration(t, ReportErrors(names), type));
+       .MapResult((tokens.Context, names, type), static (t, s) => new VariableDeclaration(t, ReportErrors(s.Context, s.names), s.type));
 
     #endregion Other
 
     #region Compiler directives
 
-    ParseResult<CompilerDirective.Assert> HashAssert(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "#assert").ParseToken(Punctuation.NumberSign)
+    ParseResult<CompilerDirective> HashAssert(TokenCursor tokens) => ParseOperation.Start(tokens, "#assert").ParseToken(Punctuation.NumberSign)
        .ParseContextKeyword(ContextKeyword.Assert).Parse(out var expr, Expression).ParseOptional(out var msg, Expression)
-       .MapResult(t => new CompilerDirective.Assert(t, expr, msg));
+       .MapResult<CompilerDirective>(t => new CompilerDirective.Assert(t, expr, msg));
 
-    ParseResult<CompilerDirective.EvalExpr> HashEvalExpr(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "#eval expr")
+    ParseResult<CompilerDirective> HashEvalExpr(TokenCursor tokens) => ParseOperation.Start(tokens, "#eval expr")
        .ParseToken(Punctuation.NumberSign).ParseContextKeyword(ContextKeyword.Eval).ParseContextKeyword(ContextKeyword.Expr).Parse(out var expr, Expression)
-       .MapResult(t => new CompilerDirective.EvalExpr(t, expr));
+       .MapResult<CompilerDirective>(t => new CompilerDirective.EvalExpr(t, expr));
 
-    ParseResult<CompilerDirective.EvalType> HashEvalType(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "#eval type")
+    ParseResult<CompilerDirective> HashEvalType(TokenCursor tokens) => ParseOperation.Start(tokens, "#eval type")
        .ParseToken(Punctuation.NumberSign).ParseContextKeyword(ContextKeyword.Eval).ParseToken(Keyword.Type).Parse(out var type, _type)
-       .MapResult(t => new CompilerDirective.EvalType(t, type));
+       .MapResult<CompilerDirective>(t => new CompilerDirective.EvalType(t, type));
 
     #endregion Compiler directives
 
     #region Terminals
 
-    static readonly IReadOnlyDictionary<TokenType, ParameterMode> parameterActualModes = new Dictionary<TokenType, ParameterMode> {
+    static readonly TokenTypeMap<ParameterMode> parameterActualModes = new() {
         [Keyword.EntE] = ParameterMode.In, [Keyword.SortE] = ParameterMode.Out, [Keyword.EntSortE] = ParameterMode.InOut,
     };
 
-    static readonly IReadOnlyDictionary<TokenType, ParameterMode> parameterFormalModes = new Dictionary<TokenType, ParameterMode> {
+    static readonly TokenTypeMap<ParameterMode> parameterFormalModes = new() {
         [Keyword.EntF] = ParameterMode.In, [Keyword.SortF] = ParameterMode.Out, [Keyword.EntSortF] = ParameterMode.InOut,
     };
 
-    ParseResult<Ident> Identifier(IEnumerable<Token> tokens) => ParseOperation.Start(tokens, "identifier").ParseTokenValue(out var name, Valued.Identifier)
-       .MapResult(t => new Ident(t, name));
+    ParseResult<Ident> Identifier(TokenCursor tokens) => ParseOperation.Start(tokens, "identifier").ParseToken(out var token, Valued.Identifier)
+       .MapResult(token, static (t, token) => new Ident(t, token));
 
     #endregion Terminals
 
-    T[] ReportErrors<T>(IEnumerable<ParseResult<T>> source) =>
-        source.Select(pr => pr.DropError(err => _msger.Report(Message.ErrorSyntax(pr.SourceTokens.Location, err)))).WhereSome().ToArray();
+    static T[] ReportErrors<T>(ParseContext context, IReadOnlyList<ParseResult<T>> source)
+    {
+        List<T> values = new(source.Count);
+        foreach (var pr in source) {
+            if (pr.HasValue) {
+                values.Add(pr.Value);
+            } else if (!context.NestingLimitExceeded) {
+                context.Messenger.Report(Message.ErrorSyntax(pr.SourceTokens.Location, pr.Error));
+            }
+        }
+        return values.ToArray();
+    }
 }
@@ -0,0 +1,41 @@
+using Scover.Psdc.Lexing;
+
+namespace Scover.Psdc.Parsing;
+
+/// <summary>
+/// A position in the tokens of a parse. Parsers receive the cursor at which they start.
+/// </summary>
+/// <remarks>Lookahead and advancing are O(1), regardless of how deeply productions are nested.</remarks>
+readonly struct TokenCursor
+{
+    public TokenCursor(ParseContext context) : this(context, 0) { }
+
+    TokenCursor(ParseContext context, int index) => (Context, Index) = (context, index);
+
+    /// <summary>Gets the parse this cursor is a position of.</summary>
+    public ParseContext Context { get; }
+
+    /// <summary>Gets the index of the cursor in the token array.</summary>
+    public int Index { get; }
+
+    /// <summary>Gets the number of tokens remaining after the cursor.</summary>
+    public int Count => Math.Max(0, Context.Tokens.Length - Index);
+
+    /// <summary>Gets the token at an offset from the cursor.</summary>
+    /// <exception cref="IndexOutOfRangeException"><paramref name="offset"/> is past the end of the tokens.</exception>
+    public Token this[int offset] => Context.Tokens[Index + offset];
+
+    /// <summary>Gets the token at an offset from the cursor, if there is one.</summary>
+    public ValueOption<Token> Peek(int offset = 0)
+    {
+        var tokens = Context.Tokens;
+        return (uint)(Index + offset) < (uint)tokens.Length
+            ? tokens[Index + offset].Some()
+            : default;
+    }
+
+    /// <summary>Moves the cursor forward.</summary>
+    /// <param name="count">The number of tokens to advance by.</param>
+    /// <returns>A new cursor, <paramref name="count"/> tokens further.</returns>
+    public TokenCursor Advance(int count) => new(Context, Index + count);
+}
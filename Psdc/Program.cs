@@ -20,48 +20,71 @@ static class Program
         s.GetoptMode = true;
         s.CaseInsensitiveEnumValues = true;
     }).ParseArguments<CliOptions>(args).MapResult(static opt => {
+        if (opt.Validate() is { } error) {
+            WriteError(error);
+            return SysExit.Usage;
+        }
         using var output = OpenOutput(opt);
         if (output is null) {
             return SysExit.CantCreat;
         }
         var input = ReadInput(opt);
-        return input is null ? SysExit.NoInput : Compile(output, input, opt);
+        return input is null ? SysExit.NoInput : CompileOnDedicatedStack(output, input, opt);
     }, _ => SysExit.Usage);
 
+    // The stack the compilation needs regardless of nesting: 1 MiB, the smallest default stack size among platforms.
+    public const int BaseStackSize = 1024 * 1024;
+    // Compilation stages recurse once per level of nesting, using up to a few kilobytes of stack each time.
+    public const int StackSizePerNestingLevel = 16 * 1024;
+    // The largest stack the compilation runs on: 1 GiB, which bounds the maximum nesting depth.
+    public const int MaxStackSize = 1024 * 1024 * 1024;
+
+    // Run the compilation on a thread whose stack can hold the maximum nesting depth, whatever the default stack size of the platform.
+    static int CompileOnDedicatedStack(TextWriter output, string input, CliOptions opt)
+    {
+        int exitCode = 0;
+        Thread compilation = new(() => exitCode = Compile(output, input, opt),
+            BaseStackSize + opt.MaxNestingDepth * StackSizePerNestingLevel);
+        compilation.Start();
+        compilation.Join();
+        return exitCode;
+    }
+
     static void WriteError(string message) =>
         msgOutput.WriteLine($"{Path.GetRelativePath(Environment.CurrentDirectory, Environment.ProcessPath ?? "psdc")}: error: {message}");
 
     static int Compile(TextWriter output, string input, CliOptions opt)
     {
-        if (!CodeGenerator.TryGet(opt.TargetLanguage, out var codeGenerator)) {
+        if (!CodeGenerator.TryGet(opt.TargetLanguage, out var codeGenerator,
+            maxDegreeOfParallelism: opt.MaxDegreeOfParallelism, constantObjects: opt.ConstObjects, maxCopySize: opt.MaxCopySize)) {
             WriteError($"unknown language: '{opt.TargetLanguage}'");
             return SysExit.Usage;
         }
 
         FilterMessenger msger = new(code => opt.Pedantic || code is not MessageCode.UnofficialFeature);
 
+        NameTable names = new();
         var tokens = "Tokenizing".LogOperation(opt.Verbose,
-            () => Lexer.Lex(msger, input).ToArray());
+            () => Lexer.Lex(msger, input, names).ToArray());
 
         var ast = "Parsing".LogOperation(opt.Verbose,
-            () => Parser.Parse(msger, tokens));
+            () => Parser.Parse(msger, tokens, maxNestingDepth: opt.MaxNestingDepth));
 
         if (ast.HasValue) {
             var sast = "Analyzing".LogOperation(opt.Verbose,
-                () => StaticAnalyzer.Analyze(msger, input, ast.Value));
-
-            string cCode = "Generating code".LogOperation(opt.Verbose,
-                () => codeGenerator(msger, sast));
+                () => StaticAnalyzer.Analyze(msger, input, names, ast.Value));
 
-            output.Write(cCode);
+            "Generating code".LogOperation(opt.Verbose,
+                () => codeGenerator(msger, sast, output));
         }
 
         msgOutput.WriteLine();
 
+        LineMap lines = new(input);
         MessagePrinter msgPrinter = opt.MsgStyle switch {
             MessageStyle.Gnu => CreateMessagePrinter(MessageTextPrinter.Style.Gnu),
             MessageStyle.VSCode => CreateMessagePrinter(MessageTextPrinter.Style.VSCode),
-            MessageStyle.Json => new MessageJsonPrinter(msgOutput, input),
+            MessageStyle.Json => new MessageJsonPrinter(msgOutput, lines),
             _ => throw opt.MsgStyle.ToUnmatchedException(),
         };
 
@@ -75,7 +98,7 @@ static class Program
         MessageTextPrinter CreateMessagePrinter(MessageTextPrinter.Style style) => new(
             msgOutput,
             opt.Input == CliOptions.StdStreamPlaceholder ? "<stdin>" : opt.Input,
-            input,
+            lines,
             style);
     }
 
@@ -49,25 +49,25 @@ interface EvaluatedType : IFormattableUsable, EquatableSemantics<EvaluatedType>
     /// <summary>
     /// Get the value for this type that is not known at compile-time.
     /// </summary>
-    /// <value>A value of this type, whose status is always <see cref="ValueStatus.Runtime"/>.</value>
+    /// <value>A value of this type, whose status is always <see cref="ValueStatusKind.Runtime"/>.</value>
     Value RuntimeValue { get; }
 
     /// <summary>
     /// Get the value for this type that is not known, either at run-time or compile-time.
     /// </summary>
-    /// <value>A value of this type, whose  is always <see cref="ValueStatus.Garbage"/>.</value>
+    /// <value>A value of this type, whose  is always <see cref="ValueStatusKind.Garbage"/>.</value>
     Value GarbageValue { get; }
 
     /// <summary>
     /// Get the default value for this type.
     /// </summary>
-    /// <value>A value of this type, whose status is always <see cref="ValueStatus.Garbage"/> or <see cref="ValueStatus.Comptime"/>. Represents the default value to set to in an initializer.</value>
+    /// <value>A value of this type, whose status is always <see cref="ValueStatusKind.Garbage"/> or <see cref="ValueStatusKind.Comptime"/>. Represents the default value to set to in an initializer.</value>
     Value DefaultValue { get; }
 
     /// <summary>
     /// Gets the invalid value for this type
     /// </summary>
-    /// <value>A value of this type, whose status is always <see cref="ValueStatus.Invalid"/>.</value>
+    /// <value>A value of this type, whose status is always <see cref="ValueStatusKind.Invalid"/>.</value>
     Value InvalidValue { get; }
 
     /// <summary>
@@ -88,7 +88,7 @@ interface EvaluatedType<out TValue> : EvaluatedType where TValue : Value
     /// <inheritdoc cref="EvaluatedType.InvalidValue"/>
     new TValue InvalidValue { get; }
 }
-sealed class ArrayType : EvaluatedTypeImplInstantiable<ArrayValue, ImmutableArray<Value>>
+sealed class ArrayType : EvaluatedTypeImplInstantiable<ArrayValue, SparseArray<Value>>
 {
     ArrayType(EvaluatedType itemType, ComptimeExpression<int> length, ValueOption<Ident> alias)
         : base(alias, CreateDefaultValue(itemType, length))
@@ -101,9 +101,8 @@ sealed class ArrayType : EvaluatedTypeImplInstantiable<ArrayValue, ImmutableArra
 
     public EvaluatedType ItemType { get; }
 
-    public ImmutableArray<Value> CreateDefaultValue() => CreateDefaultValue(ItemType, Length);
-    static ImmutableArray<Value> CreateDefaultValue(EvaluatedType type, ComptimeExpression<int> length) =>
-        [..Enumerable.Repeat(type.DefaultValue, length.Value)];
+    public SparseArray<Value> CreateDefaultValue() => CreateDefaultValue(ItemType, Length);
+    static SparseArray<Value> CreateDefaultValue(EvaluatedType type, ComptimeExpression<int> length) => new(length.Value, type.DefaultValue);
 
     public ArrayType(
         EvaluatedType itemType,
@@ -113,15 +112,19 @@ sealed class ArrayType : EvaluatedTypeImplInstantiable<ArrayValue, ImmutableArra
 
     public override ArrayType ToAliasReference(Ident alias) => new(ItemType, Length, alias);
 
-    public override bool SemanticsEqual(EvaluatedType other) => other is ArrayType o
-                                                             && o.ItemType.SemanticsEqual(ItemType)
-                                                             && o.Length.Value == Length.Value;
+    Dictionary<EvaluatedType, bool>? _semanticsEqual;
 
-    protected override ArrayValue CreateValue(ValueStatus<ImmutableArray<Value>> status)
+    public override bool SemanticsEqual(EvaluatedType other) => ReferenceEquals(this, other)
+                                                             || other is ArrayType && Memoize(this, ref _semanticsEqual, other,
+                                                                    static (self, other) => other is ArrayType o
+                                                                                         && o.Length.Value == self.Length.Value
+                                                                                         && o.ItemType.SemanticsEqual(self.ItemType));
+
+    protected override ArrayValue CreateValue(ValueStatus<SparseArray<Value>> status)
     {
         Debug.Assert(status.ComptimeValue is not { HasValue: true } c
-                  || c.Value.Length == Length.Value
-                  && c.Value.All(v => v.Type.IsConvertibleTo(ItemType)));
+                  || c.Value.Count == Length.Value
+                  && c.Value.SetItems.All(i => i.Value.Type.IsConvertibleTo(ItemType)));
         return new(this, status);
     }
 
@@ -152,7 +155,12 @@ sealed class BooleanType : EvaluatedTypeImplInstantiable<BooleanValue, bool>
     public static BooleanType Instance { get; } = new(default);
     public override BooleanType ToAliasReference(Ident alias) => new(alias);
 
+    BooleanValue? _true, _false;
+
     public override bool SemanticsEqual(EvaluatedType other) => other is BooleanType;
+    public override BooleanValue Instanciate(bool value) => value
+        ? _true ??= base.Instanciate(true)
+        : _false ??= base.Instanciate(false);
     protected override BooleanValue CreateValue(ValueStatus<bool> status) => new(this, status);
     protected override string ToStringNoAlias(IFormatProvider? fmtProvider) => "booléen";
 }
@@ -168,7 +176,7 @@ sealed class CharacterType : EvaluatedTypeImplInstantiable<CharacterValue, char>
 }
 sealed class FileType : EvaluatedTypeImplNotInstantiable<FileValue>
 {
-    FileType(ValueOption<Ident> alias) : base(alias, ValueStatus.Garbage.Instance) { }
+    FileType(ValueOption<Ident> alias) : base(alias, ValueStatus.Garbage) { }
 
     public static FileType Instance { get; } = new(default);
     public override FileType ToAliasReference(Ident alias) => new(alias);
@@ -179,7 +187,7 @@ sealed class FileType : EvaluatedTypeImplNotInstantiable<FileValue>
 }
 sealed class LengthedStringType : EvaluatedTypeImplInstantiable<LengthedStringValue, string>
 {
-    LengthedStringType(Option<Expr> lengthExpression, int length, ValueOption<Ident> alias = default) : base(alias, ValueStatus.Garbage<string>.Instance)
+    LengthedStringType(Option<Expr> lengthExpression, int length, ValueOption<Ident> alias = default) : base(alias, ValueStatus<string>.Garbage)
     {
         LengthConstantExpression = lengthExpression;
         Length = length;
@@ -205,6 +213,10 @@ sealed class LengthedStringType : EvaluatedTypeImplInstantiable<LengthedStringVa
 }
 sealed class IntegerType : EvaluatedTypeImplInstantiable<IntegerValue, int>
 {
+    // Constant folding produces a lot of small integers, so their values are shared.
+    const int MinCachedValue = -128, MaxCachedValue = 1023;
+    IntegerValue?[]? _cachedValues;
+
     IntegerType(ValueOption<Ident> alias) : base(alias, 0) { }
 
     public static IntegerType Instance { get; } = new(default);
@@ -213,6 +225,9 @@ sealed class IntegerType : EvaluatedTypeImplInstantiable<IntegerValue, int>
     public override bool IsConvertibleTo(EvaluatedType other) => base.IsConvertibleTo(other) || other is RealType;
 
     public override bool SemanticsEqual(EvaluatedType other) => other is IntegerType;
+    public override IntegerValue Instanciate(int value) => value is >= MinCachedValue and <= MaxCachedValue
+        ? (_cachedValues ??= new IntegerValue?[MaxCachedValue - MinCachedValue + 1])[value - MinCachedValue] ??= base.Instanciate(value)
+        : base.Instanciate(value);
     protected override IntegerValue CreateValue(ValueStatus<int> status) => new(this, status);
     protected override string ToStringNoAlias(IFormatProvider? fmtProvider) => "entier";
 }
@@ -227,7 +242,7 @@ sealed class RealType : EvaluatedTypeImplInstantiable<RealValue, decimal>
 }
 sealed class StringType : EvaluatedTypeImplInstantiable<StringValue, string>
 {
-    StringType(ValueOption<Ident> alias) : base(alias, ValueStatus.Garbage<string>.Instance) { }
+    StringType(ValueOption<Ident> alias) : base(alias, ValueStatus<string>.Garbage) { }
 
     public static StringType Instance { get; } = new(default);
 
@@ -246,9 +261,19 @@ sealed class StructureType(ImmutableOrderedMap<Ident, EvaluatedType> components,
     public ImmutableOrderedMap<Ident, EvaluatedType> Components { get; } = components;
     public override StructureType ToAliasReference(Ident alias) => new(Components, alias);
 
-    public override bool SemanticsEqual(EvaluatedType other) => other is StructureType o
-                                                             && o.Components.Map.Keys.AllEqual(Components.Map.Keys)
-                                                             && o.Components.Map.Values.AllSemanticsEqual(Components.Map.Values);
+    Dictionary<EvaluatedType, bool>? _semanticsEqual;
+    Dictionary<Ident, int>? _componentIndexes;
+
+    /// <summary>Gets the position of a component in <see cref="Components"/>.</summary>
+    public ValueOption<int> IndexOfComponent(Ident component) => (_componentIndexes ??= Components.List
+           .Select((c, i) => KeyValuePair.Create(c.Key, i)).ToDictionary())
+       .GetValueOrNone(component);
+
+    public override bool SemanticsEqual(EvaluatedType other) => ReferenceEquals(this, other)
+                                                             || other is StructureType && Memoize(this, ref _semanticsEqual, other,
+                                                                    static (self, other) => other is StructureType o
+                                                                                         && o.Components.Map.Keys.AllEqual(self.Components.Map.Keys)
+                                                                                         && o.Components.Map.Values.AllSemanticsEqual(self.Components.Map.Values));
 
     public ImmutableOrderedMap<Ident, Value> CreateDefaultValue() => CreateDefaultValue(Components);
 
@@ -278,7 +303,7 @@ sealed class StructureType(ImmutableOrderedMap<Ident, EvaluatedType> components,
 }
 sealed class VoidType : EvaluatedTypeImplNotInstantiable<VoidValue>
 {
-    VoidType(ValueOption<Ident> alias) : base(alias, ValueStatus.Runtime.Instance) { }
+    VoidType(ValueOption<Ident> alias) : base(alias, ValueStatus.Runtime) { }
     public static VoidType Instance { get; } = new(default);
     public override VoidType ToAliasReference(Ident alias) => new(alias);
     public override bool SemanticsEqual(EvaluatedType other) => other is VoidType;
@@ -288,7 +313,7 @@ sealed class VoidType : EvaluatedTypeImplNotInstantiable<VoidValue>
 sealed class UnknownType : EvaluatedTypeImplNotInstantiable<UnknownValue>
 {
     readonly string _repr;
-    UnknownType(Range location, string repr, ValueOption<Ident> alias = default) : base(alias, ValueStatus.Invalid.Instance) =>
+    UnknownType(Range location, string repr, ValueOption<Ident> alias = default) : base(alias, ValueStatus.Invalid) =>
         (Location, _repr) = (location, repr);
 
     public Range Location { get; }
@@ -8,7 +8,7 @@ where TValue : Value
     public Option<Ident> Alias { get; } = alias;
     protected abstract string ToStringNoAlias(IFormatProvider? fmtProvider);
 
-    public virtual bool IsConvertibleTo(EvaluatedType other) => SemanticsEqual(other) || other is EvaluatedTypeImpl<TValue> o && o.IsConvertibleFrom(this);
+    public virtual bool IsConvertibleTo(EvaluatedType other) => ReferenceEquals(this, other) || SemanticsEqual(other) || other is EvaluatedTypeImpl<TValue> o && o.IsConvertibleFrom(this);
 
     public virtual bool IsAssignableTo(EvaluatedType other) => IsConvertibleTo(other);
 
@@ -23,6 +23,31 @@ where TValue : Value
 
     public abstract EvaluatedType ToAliasReference(Ident alias);
 
+    /// <summary>
+    /// Memoizes a comparison with other types, by reference.
+    /// </summary>
+    /// <param name="self">This type.</param>
+    /// <param name="memo">The results of <paramref name="comparison"/> so far.</param>
+    /// <param name="other">The type to compare this type with.</param>
+    /// <param name="comparison">The comparison, which should not capture anything.</param>
+    /// <returns>The result of <paramref name="comparison"/>.</returns>
+    /// <remarks>For composite types, whose comparisons recurse into their components. Types are shared by the interner, so the same pairs are compared again and again.</remarks>
+    protected static bool Memoize<TSelf>(TSelf self, ref Dictionary<EvaluatedType, bool>? memo, EvaluatedType other, Func<TSelf, EvaluatedType, bool> comparison)
+    {
+        // Code generation may run in parallel.
+        var m = memo ?? Interlocked.CompareExchange(ref memo, new(ReferenceEqualityComparer.Instance), null) ?? memo;
+        lock (m) {
+            if (m.TryGetValue(other, out bool result)) {
+                return result;
+            }
+        }
+        bool newResult = comparison(self, other);
+        lock (m) {
+            m[other] = newResult;
+        }
+        return newResult;
+    }
+
     public const string FmtFull = "f";
 
     public override string ToString(string? format, IFormatProvider? fmtProvider) => Alias.Match(
@@ -51,9 +76,9 @@ where TValue : class, Value
     TValue? _invalidValue;
     readonly ValueStatus _defaultValueStatus = defaultValueStatus;
     public override TValue DefaultValue => _defaultValue ??= CreateValue(_defaultValueStatus);
-    public override TValue RuntimeValue => _runtimeValue ??= CreateValue(ValueStatus.Runtime.Instance);
-    public override TValue GarbageValue => _garbageValue ??= CreateValue(ValueStatus.Garbage.Instance);
-    public override TValue InvalidValue => _invalidValue ??= CreateValue(ValueStatus.Invalid.Instance);
+    public override TValue RuntimeValue => _runtimeValue ??= CreateValue(ValueStatus.Runtime);
+    public override TValue GarbageValue => _garbageValue ??= CreateValue(ValueStatus.Garbage);
+    public override TValue InvalidValue => _invalidValue ??= CreateValue(ValueStatus.Invalid);
 
     protected abstract TValue CreateValue(ValueStatus status);
 }
@@ -62,7 +87,7 @@ abstract class EvaluatedTypeImplInstantiable<TValue, TUnderlying>(Option<Ident>
 where TValue : class, Value
 where TUnderlying : notnull
 {
-    protected EvaluatedTypeImplInstantiable(Option<Ident> alias, TUnderlying defaultValue) : this(alias, ValueStatus.Comptime.Of(defaultValue)) { }
+    protected EvaluatedTypeImplInstantiable(Option<Ident> alias, TUnderlying defaultValue) : this(alias, ValueStatus.Comptime(defaultValue)) { }
 
     TValue? _defaultValue;
     TValue? _runtimeValue;
@@ -70,10 +95,10 @@ where TUnderlying : notnull
     TValue? _invalidValue;
     readonly ValueStatus<TUnderlying> _defaultValueStatus = defaultValueStatus;
     public override TValue DefaultValue => _defaultValue ??= CreateValue(_defaultValueStatus);
-    public override TValue RuntimeValue => _runtimeValue ??= CreateValue(ValueStatus.Runtime<TUnderlying>.Instance);
-    public override TValue GarbageValue => _garbageValue ??= CreateValue(ValueStatus.Garbage<TUnderlying>.Instance);
-    public override TValue InvalidValue => _invalidValue ??= CreateValue(ValueStatus.Invalid<TUnderlying>.Instance);
+    public override TValue RuntimeValue => _runtimeValue ??= CreateValue(ValueStatus<TUnderlying>.Runtime);
+    public override TValue GarbageValue => _garbageValue ??= CreateValue(ValueStatus<TUnderlying>.Garbage);
+    public override TValue InvalidValue => _invalidValue ??= CreateValue(ValueStatus<TUnderlying>.Invalid);
 
-    public TValue Instanciate(TUnderlying value) => CreateValue(ValueStatus.Comptime.Of(value));
+    public virtual TValue Instanciate(TUnderlying value) => CreateValue(ValueStatus.Comptime(value));
     protected abstract TValue CreateValue(ValueStatus<TUnderlying> status);
 }
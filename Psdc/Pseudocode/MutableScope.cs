@@ -1,11 +1,21 @@
 using System.Diagnostics.CodeAnalysis;
+using System.Runtime.InteropServices;
 
+using Scover.Psdc.Lexing;
 using Scover.Psdc.Messages;
 
 namespace Scover.Psdc.Pseudocode;
 
-public sealed class MutableScope(Scope? scope) : Scope(scope)
+public sealed class MutableScope : Scope
 {
+    /// <summary>Creates a root scope.</summary>
+    /// <param name="names">The names of the compilation.</param>
+    public MutableScope(NameTable names) : base(names) { }
+
+    /// <summary>Creates a child scope.</summary>
+    /// <param name="parent">The parent scope.</param>
+    public MutableScope(Scope parent) : base(parent) { }
+
     public void AddOrError(Messenger messenger, Symbol symbol)
     {
         if (!TryAdd(symbol, out var existingSymbol)) {
@@ -13,12 +23,18 @@ public sealed class MutableScope(Scope? scope) : Scope(scope)
         }
     }
 
-    public bool TryAdd(Symbol symbol) => SymbolTable.TryAdd(symbol.Name.ToString(), symbol);
+    public bool TryAdd(Symbol symbol) => TryAdd(symbol, out _);
 
     public bool TryAdd(Symbol symbol, [NotNullWhen(false)] out Symbol? existingSymbol)
     {
-        var added = SymbolTable.TryAdd(symbol.Name.ToString(), symbol);
-        existingSymbol = added ? null : SymbolTable[symbol.Name.ToString()];
-        return added;
+        ref var entry = ref CollectionsMarshal.GetValueRefOrAddDefault(SymbolTable, symbol.Name.Id, out bool exists);
+        if (exists) {
+            existingSymbol = entry!;
+            return false;
+        }
+        entry = symbol;
+        ++TreeRevision.Value;
+        existingSymbol = null;
+        return true;
     }
 }
@@ -1,14 +1,53 @@
 using System.Diagnostics.CodeAnalysis;
 
+using Scover.Psdc.Lexing;
 using Scover.Psdc.Messages;
 using Scover.Psdc.Parsing;
 
 namespace Scover.Psdc.Pseudocode;
 
-public abstract class Scope(Scope? parent)
+/// <summary>
+/// A scope of symbols, keyed by the id of their name.
+/// </summary>
+/// <remarks>Deep scopes keep a flattened view of the symbols visible from their ancestors, so that lookups don't walk the whole chain of scopes.</remarks>
+public abstract class Scope
 {
-    private protected readonly Dictionary<string, Symbol> SymbolTable = [];
-    private protected readonly Scope? ParentScope = parent;
+    // Depth from which a scope keeps a flattened view of its ancestors.
+    const int FlattenedViewMinDepth = 8;
+
+    private protected readonly Dictionary<int, Symbol> SymbolTable = [];
+    private protected readonly Scope? ParentScope;
+
+    // Shared by all the scopes of a tree. Adding a symbol anywhere in the tree invalidates the flattened views.
+    private protected readonly Revision TreeRevision;
+
+    readonly int _depth;
+
+    // The symbols found in the ancestors, by name id. Null values record names that weren't found.
+    Dictionary<int, Symbol?>? _ancestorSymbols;
+    int _ancestorSymbolsRevision;
+
+    // The names of the compilation, by which symbols are keyed. Shared by all the scopes of a tree.
+    readonly NameTable _names;
+
+    private protected Scope(Scope parent)
+    {
+        ParentScope = parent;
+        TreeRevision = parent.TreeRevision;
+        _names = parent._names;
+        _depth = parent._depth + 1;
+    }
+
+    private protected Scope(NameTable names)
+    {
+        TreeRevision = new();
+        _names = names;
+    }
+
+    private protected sealed class Revision
+    {
+        public int Value;
+    }
 
     public IEnumerable<T> GetSymbols<T>() where T : Symbol
     {
@@ -19,13 +58,13 @@ public abstract class Scope(Scope? parent)
         }
     }
 
-    public Option<T, Message> GetSymbol<T>(Ident name) where T : Symbol => !TryGetSymbol(name.ToString(), out var symbol)
+    public Option<T, Message> GetSymbol<T>(Ident name) where T : Symbol => !TryGetSymbol(name, out var symbol)
         ? Message.ErrorUndefinedSymbol<T>(name).None<T, Message>()
         : symbol is not T t
             ? Message.ErrorUndefinedSymbol<T>(name, symbol).None<T, Message>()
             : t.Some<T, Message>();
 
-    public bool TryGetSymbol<T>(string name, [NotNullWhen(true)] out T? symbol) where T : Symbol
+    public bool TryGetSymbol<T>(Ident name, [NotNullWhen(true)] out T? symbol) where T : Symbol
     {
         if (TryGetSymbol(name, out var foundSymbol) && foundSymbol is T t) {
             symbol = t;
@@ -35,21 +74,57 @@ public abstract class Scope(Scope? parent)
         return false;
     }
 
-    public bool TryGetSymbol(string name, [NotNullWhen(true)] out Symbol? symbol)
+    public bool TryGetSymbol(Ident name, [NotNullWhen(true)] out Symbol? symbol)
     {
-        for (var scope = this; scope is not null; scope = scope.ParentScope) {
-            if (scope.SymbolTable.TryGetValue(name, out symbol)) {
-                return true;
+        if (SymbolTable.TryGetValue(name.Id, out symbol)) {
+            return true;
+        }
+        if (_depth < FlattenedViewMinDepth) {
+            for (var scope = ParentScope; scope is not null; scope = scope.ParentScope) {
+                if (scope.SymbolTable.TryGetValue(name.Id, out symbol)) {
+                    return true;
+                }
             }
+            return false;
         }
 
-        symbol = default;
-        return false;
+        var ancestorSymbols = GetAncestorSymbols();
+        if (!ancestorSymbols.TryGetValue(name.Id, out symbol)) {
+            symbol = FindInAncestors(name.Id);
+            ancestorSymbols.Add(name.Id, symbol);
+        }
+        return symbol is not null;
     }
 
-    public bool TryGetSymbol<T>(Ident name, [NotNullWhen(true)] out T? symbol) where T : Symbol => TryGetSymbol(name.ToString(), out symbol);
-    public bool TryGetSymbol(Ident name, [NotNullWhen(true)] out Symbol? symbol) => TryGetSymbol(name.ToString(), out symbol);
+    public bool HasSymbol(Ident name) => SymbolTable.ContainsKey(name.Id);
+
+    // Only used to check renamed identifiers, which may not appear in the source code. A name that was never interned can't be the name of a symbol.
+    public bool HasSymbol(string name) => _names.TryGetId(name, out int id) && SymbolTable.ContainsKey(id);
 
-    public bool HasSymbol(Ident name) => HasSymbol(name.ToString());
-    public bool HasSymbol(string name) => SymbolTable.ContainsKey(name);
+    Dictionary<int, Symbol?> GetAncestorSymbols()
+    {
+        if (_ancestorSymbols is null) {
+            _ancestorSymbols = [];
+        } else if (_ancestorSymbolsRevision != TreeRevision.Value) {
+            _ancestorSymbols.Clear();
+        }
+        _ancestorSymbolsRevision = TreeRevision.Value;
+        return _ancestorSymbols;
+    }
+
+    Symbol? FindInAncestors(int nameId)
+    {
+        for (var scope = ParentScope; scope is not null; scope = scope.ParentScope) {
+            if (scope.SymbolTable.TryGetValue(nameId, out var symbol)) {
+                return symbol;
+            }
+            // Stop at the first ancestor whose own view is up to date and knows the name.
+            if (scope._ancestorSymbols is { } ancestorSymbols
+             && scope._ancestorSymbolsRevision == TreeRevision.Value
+             && ancestorSymbols.TryGetValue(nameId, out symbol)) {
+                return symbol;
+            }
+        }
+        return null;
+    }
 }
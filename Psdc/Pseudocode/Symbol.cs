@@ -80,7 +80,7 @@ public interface Symbol : EquatableSemantics<Symbol>
     internal sealed record Callable(
         Ident Name,
         Range Location,
-        IReadOnlyCollection<Parameter> Parameters,
+        IReadOnlyList<Parameter> Parameters,
         EvaluatedType ReturnType
     )
         : Symbol
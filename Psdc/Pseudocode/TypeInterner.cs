@@ -0,0 +1,76 @@
+using System.Runtime.InteropServices;
+
+using Scover.Psdc.Parsing;
+
+namespace Scover.Psdc.Pseudocode;
+
+/// <summary>
+/// Shares one instance between the types of a compilation that are written the same way.
+/// </summary>
+/// <remarks>
+/// Types are keyed by the instances of the types they are made of, so those must be interned first.
+/// Types that are equal but written differently, such as arrays whose length is a constant in one and a literal in the other, are kept apart, since code generation reproduces how they are written.
+/// </remarks>
+sealed class TypeInterner(string input)
+{
+    readonly Dictionary<(EvaluatedType ItemType, int Length, string LengthSource), ArrayType> _arrays = [];
+    readonly Dictionary<(int Length, string LengthSource), LengthedStringType> _lengthedStrings = [];
+    readonly Dictionary<StructureKey, StructureType> _structures = [];
+    readonly Dictionary<(EvaluatedType Type, int Alias), EvaluatedType> _aliasReferences = [];
+
+    public ArrayType Array(EvaluatedType itemType, ComptimeExpression<int> length)
+    {
+        ref var type = ref CollectionsMarshal.GetValueRefOrAddDefault(_arrays, (itemType, length.Value, input[length.Expression.Meta.Location]), out _);
+        return type ??= new(itemType, length);
+    }
+
+    public LengthedStringType LengthedString(ComptimeExpression<int> length)
+    {
+        ref var type = ref CollectionsMarshal.GetValueRefOrAddDefault(_lengthedStrings, (length.Value, input[length.Expression.Meta.Location]), out _);
+        return type ??= LengthedStringType.Create(length);
+    }
+
+    public StructureType Structure(ImmutableOrderedMap<Ident, EvaluatedType> components)
+    {
+        ref var type = ref CollectionsMarshal.GetValueRefOrAddDefault(_structures, new(components), out _);
+        return type ??= new(components);
+    }
+
+    public EvaluatedType AliasReference(EvaluatedType type, Ident alias)
+    {
+        ref var aliasReference = ref CollectionsMarshal.GetValueRefOrAddDefault(_aliasReferences, (type, alias.Id), out _);
+        return aliasReference ??= type.ToAliasReference(alias);
+    }
+
+    // Components are equal when they have the same names and the same type instances, in the same order.
+    readonly struct StructureKey(ImmutableOrderedMap<Ident, EvaluatedType> components) : IEquatable<StructureKey>
+    {
+        readonly IReadOnlyList<KeyValuePair<Ident, EvaluatedType>> _components = components.List;
+
+        public bool Equals(StructureKey other)
+        {
+            if (_components.Count != other._components.Count) {
+                return false;
+            }
+            for (int i = 0; i < _components.Count; ++i) {
+                if (!_components[i].Key.Equals(other._components[i].Key)
+                 || !ReferenceEquals(_components[i].Value, other._components[i].Value)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        public override bool Equals(object? obj) => obj is StructureKey other && Equals(other);
+
+        public override int GetHashCode()
+        {
+            HashCode hash = new();
+            foreach (var (name, type) in _components) {
+                hash.Add(name.Id);
+                hash.Add(type);
+            }
+            return hash.ToHashCode();
+        }
+    }
+}
@@ -1,4 +1,3 @@
-using System.Collections.Immutable;
 using System.Text;
 
 using Scover.Psdc.CodeGeneration;
@@ -29,7 +28,7 @@ sealed class IntegerValue(IntegerType type, ValueStatus<int> value)
     : ValueImpl<IntegerValue, IntegerType, int>(type, value), RealValue
 {
     RealType Value<RealType, decimal>.Type => RealType.Instance;
-    ValueStatus<decimal> Value<RealType, decimal>.Status => Status.Map(v => (decimal)v);
+    ValueStatus<decimal> Value<RealType, decimal>.Status => Status.Map(static v => (decimal)v);
     protected override IntegerValue Clone(ValueStatus<int> value) => new(Type, value);
     protected override string ValueToString(int value, IFormatProvider? fmtProvider, Indentation indent) => value.ToString(fmtProvider);
 }
@@ -64,10 +63,10 @@ sealed class StructureValue(StructureType type, ValueStatus<ImmutableOrderedMap<
 }
 sealed class VoidValue(VoidType type, ValueStatus value) : ValueImpl<VoidType>(type, value);
 sealed class UnknownValue(UnknownType type, ValueStatus value) : ValueImpl<UnknownType>(type, value);
-sealed class ArrayValue(ArrayType type, ValueStatus<ImmutableArray<Value>> value) : ValueImpl<ArrayValue, ArrayType, ImmutableArray<Value>>(type, value)
+sealed class ArrayValue(ArrayType type, ValueStatus<SparseArray<Value>> value) : ValueImpl<ArrayValue, ArrayType, SparseArray<Value>>(type, value)
 {
-    protected override ArrayValue Clone(ValueStatus<ImmutableArray<Value>> value) => new(Type, value);
-    protected override string ValueToString(ImmutableArray<Value> value, IFormatProvider? fmtProvider, Indentation indent)
+    protected override ArrayValue Clone(ValueStatus<SparseArray<Value>> value) => new(Type, value);
+    protected override string ValueToString(SparseArray<Value> value, IFormatProvider? fmtProvider, Indentation indent)
     {
         StringBuilder o = new();
         o.AppendLine("{");
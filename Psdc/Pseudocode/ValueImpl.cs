@@ -4,12 +4,12 @@ namespace Scover.Psdc.Pseudocode;
 
 file static class ValueStatusExtensions
 {
-    public static string GetPart(this ValueStatus valueStatus) => valueStatus switch {
-        ValueStatus.Comptime => "comptime ",
-        ValueStatus.Garbage => "garbage ",
-        ValueStatus.Invalid => "invalid ",
-        ValueStatus.Runtime => "runtime ",
-        _ => throw valueStatus.ToUnmatchedException(),
+    public static string GetPart(this ValueStatusKind kind) => kind switch {
+        ValueStatusKind.Comptime => "comptime ",
+        ValueStatusKind.Garbage => "garbage ",
+        ValueStatusKind.Invalid => "invalid ",
+        ValueStatusKind.Runtime => "runtime ",
+        _ => throw kind.ToUnmatchedException(),
     };
 }
 abstract class ValueImpl<TType>(TType type, ValueStatus status) : FormattableUsableImpl, Value
@@ -23,7 +23,7 @@ where TType : EvaluatedType
                                      && o.Status.Equals(Status);
     public override string ToString(string? format, IFormatProvider? fmtProvider) => format switch {
         Value.FmtMin => Type.ToString(fmtProvider),
-        _ when string.IsNullOrEmpty(format) => string.Create(fmtProvider, $"{Status.GetPart()}'{Type}'"),
+        _ when string.IsNullOrEmpty(format) => string.Create(fmtProvider, $"{Status.Kind.GetPart()}'{Type}'"),
         _ => throw new FormatException($"Unsupported format: '{format}'"),
     };
     public string ToString(string? format, IFormatProvider? fmtProvider, Indentation indent) => ToString(format, fmtProvider);
@@ -36,7 +36,11 @@ where TUnderlying : notnull
     public TType Type { get; } = type;
     public ValueStatus<TUnderlying> Status { get; } = status;
     EvaluatedType Value.Type => Type;
-    ValueStatus Value.Status => Status;
+    // Cached since converting boxes the comptime value. A reference, so that values can be read from several threads.
+    object? _boxedComptimeValue;
+    ValueStatus Value.Status => Status.ComptimeValue is { HasValue: true } v
+        ? ValueStatus.Of(ValueStatusKind.Comptime, _boxedComptimeValue ??= v.Value)
+        : ValueStatus.Of(Status.Kind, null);
     public bool Equals(Value? other) => other is TSelf o
                                      && o.Type.SemanticsEqual(Type)
                                      && o.Status.Equals(Status);
@@ -48,8 +52,8 @@ where TUnderlying : notnull
         Value.FmtNoType => Status.ComptimeValue.Map(v => ValueToString(v, fmtProvider, indent)).ValueOr(""),
         Value.FmtMin => Status.ComptimeValue.Map(v => ValueToString(v, fmtProvider, indent)).ValueOr(Type.ToString(fmtProvider)),
         "" or null => Status.ComptimeValue.Match(
-            v => string.Create(fmtProvider, $"{Status.GetPart()}'{Type}' : {ValueToString(v, fmtProvider, indent)}"),
-            () => string.Create(fmtProvider, $"{Status.GetPart()}'{Type}'")),
+            v => string.Create(fmtProvider, $"{Status.Kind.GetPart()}'{Type}' : {ValueToString(v, fmtProvider, indent)}"),
+            () => string.Create(fmtProvider, $"{Status.Kind.GetPart()}'{Type}'")),
         _ => throw new FormatException($"Unsupported format: '{format}'"),
     };
 }
@@ -1,89 +1,86 @@
 namespace Scover.Psdc.Pseudocode;
 
-interface ValueStatus : IEquatable<ValueStatus>
+enum ValueStatusKind
 {
-    ValueOption<object> ComptimeValue { get; }
-
     /// <summary>
     /// The value is known at compile-time.
     /// </summary>
-    internal class Comptime : ValueStatus
-    {
-        /// <summary>
-        /// Status for a value that is known at compile-time.
-        /// </summary>
-        /// <typeparam name="TUnderlying">The type of the underlying value.</typeparam>
-        /// <param name="value">The actual value.</param>
-        public static Comptime<TUnderlying> Of<TUnderlying>(TUnderlying value) where TUnderlying : notnull => new(value);
-        protected Comptime(object value) => Value = value;
-        public object Value { get; }
-        ValueOption<object> ValueStatus.ComptimeValue => Value;
-        public bool Equals(ValueStatus? other) => other is Comptime o && Equals(o.Value, Value);
-    }
-    internal sealed class Comptime<TUnderlying>(TUnderlying value) : Comptime(value), ValueStatus<TUnderlying>
-    where TUnderlying : notnull
-    {
-        public new TUnderlying Value { get; } = value;
-        public ValueOption<TUnderlying> ComptimeValue => Value;
-        ValueStatus<TResult> ValueStatus<TUnderlying>.Map<TResult>(Func<TUnderlying, TResult> transform) => Of(transform(Value));
-    }
-
+    Comptime,
     /// <summary>
     /// The value is known at run-time.
     /// </summary>
     /// <remarks>Example: return value of a function call.</remarks>
-    internal abstract class Runtime : ValueStatus
-    {
-        ValueOption<object> ValueStatus.ComptimeValue => default;
-        public bool Equals(ValueStatus? other) => other is Runtime;
-        public static Runtime Instance => Runtime<object>.Instance;
-    }
-    internal sealed class Runtime<TUnderlying> : Runtime, ValueStatus<TUnderlying>
-    {
-        Runtime() { }
-        public new static Runtime<TUnderlying> Instance { get; } = new();
-        public ValueOption<TUnderlying> ComptimeValue => default;
-        ValueStatus<TResult> ValueStatus<TUnderlying>.Map<TResult>(Func<TUnderlying, TResult> transform) => Runtime<TResult>.Instance;
-    }
-
+    Runtime,
     /// <summary>
     /// The value is neither known at compile-time nor run-time.
     /// </summary>
     /// <remarks>Example: unitialized variable, unallocated memory.</remarks>
-    internal abstract class Garbage : ValueStatus
-    {
-        ValueOption<object> ValueStatus.ComptimeValue => default;
-        public bool Equals(ValueStatus? other) => other is Garbage;
-        public static Garbage Instance => Garbage<object>.Instance;
-    }
-    internal sealed class Garbage<TUnderlying> : Garbage, ValueStatus<TUnderlying>
-    {
-        Garbage() { }
-        public new static Garbage<TUnderlying> Instance { get; } = new();
-        public ValueOption<TUnderlying> ComptimeValue => default;
-        ValueStatus<TResult> ValueStatus<TUnderlying>.Map<TResult>(Func<TUnderlying, TResult> transform) => Garbage<TResult>.Instance;
-    }
-
+    Garbage,
     /// <summary>
     /// The value is a semantically invalid and causes a compilation error.
     /// </summary>
-    internal abstract class Invalid : ValueStatus
-    {
-        ValueOption<object> ValueStatus.ComptimeValue => default;
-        public bool Equals(ValueStatus? other) => other is Invalid;
-        public static Invalid Instance => Invalid<object>.Instance;
-    }
-    internal sealed class Invalid<TUnderlying> : Invalid, ValueStatus<TUnderlying>
-    {
-        Invalid() { }
-        public new static Invalid<TUnderlying> Instance { get; } = new();
-        public ValueOption<TUnderlying> ComptimeValue => default;
-        ValueStatus<TResult> ValueStatus<TUnderlying>.Map<TResult>(Func<TUnderlying, TResult> transform) => Invalid<TResult>.Instance;
-    }
+    Invalid,
 }
 
-interface ValueStatus<TUnderlying> : ValueStatus
+/// <summary>
+/// The status of a value of any type.
+/// </summary>
+readonly struct ValueStatus : IEquatable<ValueStatus>
 {
-    ValueStatus<TResult> Map<TResult>(Func<TUnderlying, TResult> transform) where TResult : notnull;
-    new ValueOption<TUnderlying> ComptimeValue { get; }
+    readonly object? _comptimeValue;
+
+    ValueStatus(ValueStatusKind kind, object? comptimeValue) => (Kind, _comptimeValue) = (kind, comptimeValue);
+
+    public static ValueStatus Runtime { get; } = new(ValueStatusKind.Runtime, null);
+    public static ValueStatus Garbage { get; } = new(ValueStatusKind.Garbage, null);
+    public static ValueStatus Invalid { get; } = new(ValueStatusKind.Invalid, null);
+
+    /// <summary>
+    /// Status for a value that is known at compile-time.
+    /// </summary>
+    /// <typeparam name="TUnderlying">The type of the underlying value.</typeparam>
+    /// <param name="value">The actual value.</param>
+    public static ValueStatus<TUnderlying> Comptime<TUnderlying>(TUnderlying value) where TUnderlying : notnull => new(value);
+
+    internal static ValueStatus Of(ValueStatusKind kind, object? comptimeValue) => new(kind, comptimeValue);
+
+    public ValueStatusKind Kind { get; }
+
+    public ValueOption<object> ComptimeValue => Kind is ValueStatusKind.Comptime ? _comptimeValue.NotNull().Some() : default;
+
+    public bool Equals(ValueStatus other) => Kind == other.Kind && Equals(_comptimeValue, other._comptimeValue);
+    public override bool Equals(object? obj) => obj is ValueStatus other && Equals(other);
+    public override int GetHashCode() => HashCode.Combine(Kind, _comptimeValue);
+}
+
+/// <summary>
+/// The status of a value, with its underlying value when it is known at compile-time.
+/// </summary>
+/// <typeparam name="TUnderlying">The type of the underlying value.</typeparam>
+/// <remarks>This is a struct, so statuses don't allocate.</remarks>
+readonly struct ValueStatus<TUnderlying> : IEquatable<ValueStatus<TUnderlying>>
+{
+    readonly TUnderlying? _value;
+
+    ValueStatus(ValueStatusKind kind) => Kind = kind;
+    internal ValueStatus(TUnderlying value) => (Kind, _value) = (ValueStatusKind.Comptime, value);
+
+    public static ValueStatus<TUnderlying> Runtime => new(ValueStatusKind.Runtime);
+    public static ValueStatus<TUnderlying> Garbage => new(ValueStatusKind.Garbage);
+    public static ValueStatus<TUnderlying> Invalid => new(ValueStatusKind.Invalid);
+
+    public ValueStatusKind Kind { get; }
+
+    public ValueOption<TUnderlying> ComptimeValue => Kind is ValueStatusKind.Comptime ? _value!.Some() : default;
+
+    public ValueStatus<TResult> Map<TResult>(Func<TUnderlying, TResult> transform) where TResult : notnull =>
+        Kind is ValueStatusKind.Comptime ? new(transform(_value!)) : new(Kind);
+
+    public bool Equals(ValueStatus<TUnderlying> other) => Kind == other.Kind && EqualityComparer<TUnderlying>.Default.Equals(_value, other._value);
+    public override bool Equals(object? obj) => obj is ValueStatus<TUnderlying> other && Equals(other);
+    public override int GetHashCode() => HashCode.Combine(Kind, _value);
+
+    // Only a comptime value is boxed, not the default value of other statuses.
+    public static implicit operator ValueStatus(ValueStatus<TUnderlying> status)
+        => ValueStatus.Of(status.Kind, status.Kind is ValueStatusKind.Comptime ? status._value : null);
 }
@@ -1,24 +1,24 @@
 using Scover.Psdc.Lexing;
+using Scover.Psdc.Parsing;
 
 namespace Scover.Psdc;
 
-public sealed class SourceTokens
+public readonly struct SourceTokens
 {
-    readonly Lazy<Range> _location;
-    public SourceTokens(IEnumerable<Token> tokens, int count)
+    internal SourceTokens(TokenCursor tokens, int count)
     {
         Count = count;
-        tokens = tokens.Take(count);
-        _location = count == 0
-            ? new(Range.EndAt(Index.Start))
-            : new(() => tokens.First().Position.Start..tokens.Last().Position.End);
+        int available = Math.Min(count, tokens.Count);
+        Location = available == 0
+            ? Range.EndAt(Index.Start)
+            : tokens[0].Position.Start..tokens[available - 1].Position.End;
     }
 
-    public SourceTokens(Token token) : this(token.Yield(), 1) { }
+    public SourceTokens(Token token) => (Count, Location) = (1, token.Position);
 
-    public static SourceTokens Empty { get; } = new([], 0);
+    public static SourceTokens Empty => default;
 
     public int Count { get; }
 
-    public Range Location => _location.Value;
+    public Range Location { get; }
 }
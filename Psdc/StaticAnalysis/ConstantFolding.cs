@@ -7,44 +7,49 @@ using static Scover.Psdc.Parsing.Node.BinaryOperator;
 
 namespace Scover.Psdc.StaticAnalysis;
 
+// Operations are static lambdas and operands are tested in place, so that folding doesn't allocate closures.
 static class ConstantFolding
 {
     static OperationResult<UnaryOperationMessage> Operate<TResultValue, TOperand, TResult>(
         InstantiableType<TResultValue, TResult> type,
         ValueStatus<TOperand> value,
         Func<TOperand, TResult> operation
-    ) where TResultValue : Value => OperationResult.OkUnary(
-        value.ComptimeValue.Map(v => type.Instanciate(operation(v))).ValueOr(type.RuntimeValue));
+    ) where TResultValue : Value => OperationResult.OkUnary(value.ComptimeValue is { HasValue: true } v
+        ? type.Instanciate(operation(v.Value))
+        : type.RuntimeValue);
 
     static OperationResult<BinaryOperationMessage> Operate<TResultValue, TLeft, TRight, TResult>(
         InstantiableType<TResultValue, TResult> type,
         ValueStatus<TLeft> left,
         ValueStatus<TRight> right,
         Func<TLeft, TRight, TResult> operation
-    ) where TResultValue : Value => OperationResult.OkBinary(
-        left.ComptimeValue.Zip(right.ComptimeValue).Map((l, r) => type.Instanciate(operation(l, r))).ValueOr(type.RuntimeValue));
-
-    static TResult Operate<TLeft, TRight, TResult>(
-        ValueStatus<TLeft> left,
-        ValueStatus<TRight> right,
-        Func<Option<TLeft>, Option<TRight>, TResult> operation
-    ) => operation(left.ComptimeValue, right.ComptimeValue);
+    ) where TResultValue : Value => OperationResult.OkBinary(left.ComptimeValue is { HasValue: true } l && right.ComptimeValue is { HasValue: true } r
+        ? type.Instanciate(operation(l.Value, r.Value))
+        : type.RuntimeValue);
+
+    static OperationResult<BinaryOperationMessage> DivideIntegers(ValueStatus<int> left, ValueStatus<int> right) =>
+        left.ComptimeValue is { HasValue: true } l && right.ComptimeValue is { HasValue: true } r
+            ? r.Value == 0
+                ? OperationResult.OkBinary(IntegerType.Instance.RuntimeValue)
+                   .WithMessages(static (opBin, _, _) => Message.WarningDivisionByZero(opBin.Location))
+                : OperationResult.OkBinary(IntegerType.Instance.Instanciate(l.Value / r.Value))
+            : OperationResult.OkBinary(IntegerType.Instance.RuntimeValue);
 
     internal static OperationResult<UnaryOperationMessage> EvaluateOperation(this StaticAnalyzer sa, Scope scope, UnaryOperator op, Value operand) =>
         (op, operand) switch {
             (_, UnknownValue) => OperationResult.OkUnary(operand),
 
             // Arithmetic
-            (Minus, IntegerValue x) => Operate(x.Type, x.Status, x => -x),
-            (Minus, RealValue x) => Operate(x.Type, x.Status, x => -x),
+            (Minus, IntegerValue x) => Operate(x.Type, x.Status, static x => -x),
+            (Minus, RealValue x) => Operate(x.Type, x.Status, static x => -x),
             (Plus, IntegerValue x) => OperationResult.OkUnary(x),
             (Plus, RealValue x) => OperationResult.OkUnary(x),
 
             // Bitwise
-            (Not, IntegerValue x) => Operate(x.Type, x.Status, x => ~x),
+            (Not, IntegerValue x) => Operate(x.Type, x.Status, static x => ~x),
 
             // Logical
-            (Not, BooleanValue x) => Operate(x.Type, x.Status, x => !x),
+            (Not, BooleanValue x) => Operate(x.Type, x.Status, static x => !x),
 
             // Other
             (Cast c, _) => sa.EvaluateCast(scope, c, operand),
@@ -61,11 +66,11 @@ static class ConstantFolding
         }
         // Explicit conversions
         return (operand, targetType) switch {
-            (BooleanValue bv, IntegerType it) => Operate(it, bv.Status, b => b ? 1 : 0),
+            (BooleanValue bv, IntegerType it) => Operate(it, bv.Status, static b => b ? 1 : 0),
             (CharacterValue, IntegerType it) => OperationResult.OkUnary(it.RuntimeValue), // runtime since target language encoding is unknown
-            (IntegerValue iv, BooleanType bt) => Operate(bt, iv.Status, i => i != 0),
+            (IntegerValue iv, BooleanType bt) => Operate(bt, iv.Status, static i => i != 0),
             (IntegerValue, CharacterType ct) => OperationResult.OkUnary(ct.RuntimeValue), // runtime since target language encoding is unknown
-            (RealValue rv, IntegerType it) => Operate(it, rv.Status, r => (int)r),
+            (RealValue rv, IntegerType it) => Operate(it, rv.Status, static r => (int)r),
             _ => (UnaryOperationMessage)((opUn, operandType) => Message.ErrorInvalidCast(opUn.Location, operandType, targetType)),
         };
     }
@@ -76,61 +81,56 @@ static class ConstantFolding
         (_, _, UnknownValue) => OperationResult.OkBinary(right),
 
         // Equality
-        (Equal, BooleanValue l, BooleanValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l == r),
-        (Equal, CharacterValue l, CharacterValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l == r),
-        (Equal, StringValue l, StringValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l == r),
-        (Equal, IntegerValue l, IntegerValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l == r),
-        (Equal, RealValue l, RealValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l == r)
-           .WithMessages((opBin, _, _) => Message.WarningFloatingPointEquality(opBin.Location)),
+        (Equal, BooleanValue l, BooleanValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l == r),
+        (Equal, CharacterValue l, CharacterValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l == r),
+        (Equal, StringValue l, StringValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l == r),
+        (Equal, IntegerValue l, IntegerValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l == r),
+        (Equal, RealValue l, RealValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l == r)
+           .WithMessages(static (opBin, _, _) => Message.WarningFloatingPointEquality(opBin.Location)),
 
         // Unequality
-        (NotEqual, BooleanValue l, BooleanValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l != r),
-        (NotEqual, CharacterValue l, CharacterValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l != r),
-        (NotEqual, StringValue l, StringValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l != r),
-        (NotEqual, IntegerValue l, IntegerValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l != r),
-        (NotEqual, RealValue l, RealValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l != r)
-           .WithMessages((opBin, _, _) => Message.WarningFloatingPointEquality(opBin.Location)),
+        (NotEqual, BooleanValue l, BooleanValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l != r),
+        (NotEqual, CharacterValue l, CharacterValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l != r),
+        (NotEqual, StringValue l, StringValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l != r),
+        (NotEqual, IntegerValue l, IntegerValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l != r),
+        (NotEqual, RealValue l, RealValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l != r)
+           .WithMessages(static (opBin, _, _) => Message.WarningFloatingPointEquality(opBin.Location)),
 
         // Comparison
-        (GreaterThan, IntegerValue l, IntegerValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l > r),
-        (GreaterThan, RealValue l, RealValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l > r),
-        (GreaterThan, StringValue l, StringValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => string.CompareOrdinal(l, r) > 0),
-        (GreaterThanOrEqual, IntegerValue l, IntegerValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l >= r),
-        (GreaterThanOrEqual, RealValue l, RealValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l >= r),
-        (GreaterThanOrEqual, StringValue l, StringValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => string.CompareOrdinal(l, r) >= 0),
-        (LessThan, IntegerValue l, IntegerValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l < r),
-        (LessThan, RealValue l, RealValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l < r),
-        (LessThan, StringValue l, StringValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => string.CompareOrdinal(l, r) < 0),
-        (LessThanOrEqual, IntegerValue l, IntegerValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l <= r),
-        (LessThanOrEqual, RealValue l, RealValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l <= r),
-        (LessThanOrEqual, StringValue l, StringValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => string.CompareOrdinal(l, r) <= 0),
+        (GreaterThan, IntegerValue l, IntegerValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l > r),
+        (GreaterThan, RealValue l, RealValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l > r),
+        (GreaterThan, StringValue l, StringValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => string.CompareOrdinal(l, r) > 0),
+        (GreaterThanOrEqual, IntegerValue l, IntegerValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l >= r),
+        (GreaterThanOrEqual, RealValue l, RealValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l >= r),
+        (GreaterThanOrEqual, StringValue l, StringValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => string.CompareOrdinal(l, r) >= 0),
+        (LessThan, IntegerValue l, IntegerValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l < r),
+        (LessThan, RealValue l, RealValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l < r),
+        (LessThan, StringValue l, StringValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => string.CompareOrdinal(l, r) < 0),
+        (LessThanOrEqual, IntegerValue l, IntegerValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l <= r),
+        (LessThanOrEqual, RealValue l, RealValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l <= r),
+        (LessThanOrEqual, StringValue l, StringValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => string.CompareOrdinal(l, r) <= 0),
 
         // Arithmetic
-        (Add, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, (l, r) => l + r),
-        (Add, RealValue l, RealValue r) => Operate(RealType.Instance, l.Status, r.Status, (l, r) => l + r),
-        (Divide, IntegerValue l, IntegerValue r) => Operate(l.Status, r.Status,
-            (l, r) => l.Zip(r).Map((l, r) => r == 0
-                    ? OperationResult.OkBinary(IntegerType.Instance.RuntimeValue)
-                       .WithMessages((opBin, _, _) => Message.WarningDivisionByZero(opBin.Location))
-                    : OperationResult.OkBinary(IntegerType.Instance.Instanciate(l / r)))
-               .ValueOr(OperationResult.OkBinary(IntegerType.Instance.RuntimeValue))),
-        (Divide, RealValue l, RealValue r) => Operate(RealType.Instance, l.Status, r.Status, (l, r) => l / r),
-        (Mod, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, (l, r) => l % r),
-        (Mod, RealValue l, RealValue r) => Operate(RealType.Instance, l.Status, r.Status, (l, r) => l % r),
-        (Multiply, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, (l, r) => l * r),
-        (Multiply, RealValue l, RealValue r) => Operate(RealType.Instance, l.Status, r.Status, (l, r) => l * r),
-        (Subtract, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, (l, r) => l - r),
-        (Subtract, RealValue l, RealValue r) => Operate(RealType.Instance, l.Status, r.Status, (l, r) => l - r),
+        (Add, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, static (l, r) => l + r),
+        (Add, RealValue l, RealValue r) => Operate(RealType.Instance, l.Status, r.Status, static (l, r) => l + r),
+        (Divide, IntegerValue l, IntegerValue r) => DivideIntegers(l.Status, r.Status),
+        (Divide, RealValue l, RealValue r) => Operate(RealType.Instance, l.Status, r.Status, static (l, r) => l / r),
+        (Mod, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, static (l, r) => l % r),
+        (Mod, RealValue l, RealValue r) => Operate(RealType.Instance, l.Status, r.Status, static (l, r) => l % r),
+        (Multiply, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, static (l, r) => l * r),
+        (Multiply, RealValue l, RealValue r) => Operate(RealType.Instance, l.Status, r.Status, static (l, r) => l * r),
+        (Subtract, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, static (l, r) => l - r),
+        (Subtract, RealValue l, RealValue r) => Operate(RealType.Instance, l.Status, r.Status, static (l, r) => l - r),
 
         // Bitwise
-        (And, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, (l, r) => l & r),
-        (Or, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, (l, r) => l | r),
-        (Xor, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, (l, r) => l ^ r),
+        (And, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, static (l, r) => l & r),
+        (Or, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, static (l, r) => l | r),
+        (Xor, IntegerValue l, IntegerValue r) => Operate(IntegerType.Instance, l.Status, r.Status, static (l, r) => l ^ r),
 
         // Logical
-        (And, BooleanValue l, BooleanValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l && r),
-        (Or, BooleanValue l, BooleanValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l || r),
-        (Xor, BooleanValue l, BooleanValue r) => Operate(BooleanType.Instance, l.Status, r.Status, (l, r) => l ^ r),
+        (And, BooleanValue l, BooleanValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l && r),
+        (Or, BooleanValue l, BooleanValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l || r),
+        (Xor, BooleanValue l, BooleanValue r) => Operate(BooleanType.Instance, l.Status, r.Status, static (l, r) => l ^ r),
 
         _ => (BinaryOperationMessage)Message.ErrorUnsupportedOperation,
     };
@@ -19,13 +19,13 @@ public interface SemanticNode
     {
         internal sealed record MainProgram(SemanticMetadata Meta, SemanticBlock Block) : Declaration;
 
-        internal sealed record TypeAlias(SemanticMetadata Meta, Ident Name, EvaluatedType Type) : Declaration;
+        internal sealed record TypeAlias(SemanticMetadata Meta, Symbol.TypeAlias Symbol, EvaluatedType Type) : Declaration;
 
-        internal sealed record Constant(SemanticMetadata Meta, EvaluatedType Type, Ident Name, Initializer Value) : Declaration;
+        internal sealed record Constant(SemanticMetadata Meta, EvaluatedType Type, Symbol.Constant Symbol, Initializer Value) : Declaration;
 
-        internal sealed record Callable(SemanticMetadata Meta, CallableSignature Signature) : Declaration;
+        internal sealed record Callable(SemanticMetadata Meta, Symbol.Callable Symbol, CallableSignature Signature) : Declaration;
 
-        internal sealed record CallableDefinition(SemanticMetadata Meta, CallableSignature Signature, SemanticBlock Block) : Declaration;
+        internal sealed record CallableDefinition(SemanticMetadata Meta, Symbol.Callable Symbol, CallableSignature Signature, SemanticBlock Block) : Declaration;
     }
 
     internal interface Statement : SemanticNode
@@ -117,7 +117,7 @@ public interface SemanticNode
 
             internal sealed record ArraySubscript(SemanticMetadata Meta, Expr Array, Expr Index, Value Value) : Lvalue;
 
-            internal sealed record VariableReference(SemanticMetadata Meta, Ident Name, Value Value) : Lvalue;
+            internal sealed record VariableReference(SemanticMetadata Meta, Ident Name, Option<Symbol.Variable> Symbol, Value Value) : Lvalue;
         }
 
         internal sealed record UnaryOperation(SemanticMetadata Meta, UnaryOperator Operator, Expr Operand, Value Value) : Expr;
@@ -126,7 +126,7 @@ public interface SemanticNode
 
         internal sealed record BuiltinFdf(SemanticMetadata Meta, Expr ArgumentNomLog, Value Value) : Expr;
 
-        internal sealed record Call(SemanticMetadata Meta, Ident Callee, IReadOnlyList<ParameterActual> Parameters, Value Value) : Expr;
+        internal sealed record Call(SemanticMetadata Meta, Ident Callee, Option<Symbol.Callable> Symbol, IReadOnlyList<ParameterActual> Parameters, Value Value) : Expr;
 
         internal sealed record ParenExprImpl(SemanticMetadata Meta, Expr ContainedExpression, Value Value) : ParenExpr;
 
@@ -144,7 +144,7 @@ public interface SemanticNode
 
     internal sealed record ParameterFormal(SemanticMetadata Meta, ParameterMode Mode, Ident Name, EvaluatedType Type) : SemanticNode;
 
-    internal sealed record VariableDeclaration(SemanticMetadata Meta, IReadOnlyList<Ident> Names, EvaluatedType Type) : SemanticNode;
+    internal sealed record VariableDeclaration(SemanticMetadata Meta, IReadOnlyList<Symbol.LocalVariable> Symbols, EvaluatedType Type) : SemanticNode;
 
     internal sealed record CallableSignature(SemanticMetadata Meta, Ident Name, IReadOnlyList<ParameterFormal> Parameters, EvaluatedType ReturnType)
         : SemanticNode;
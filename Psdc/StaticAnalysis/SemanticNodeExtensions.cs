@@ -11,14 +11,52 @@ public static class SemanticNodeExtensions
     /// </summary>
     /// <param name="expr">The expression.</param>
     /// <returns>The inverse of <paramref name="expr"/>. If <param name="expr"/> is not a boolean expression, a simple NOT logical operation is created.</returns>
-    internal static Expr Invert(this Expr expr) => expr switch {
-        Expr.Literal { Value: BooleanValue v } l => new Expr.Literal(expr.Meta,
-            v.Status.ComptimeValue.Match(v => !v, () => l.UnderlyingValue), v.Invert()),
-        Expr.ParenExprImpl e => new Expr.ParenExprImpl(expr.Meta, e.ContainedExpression.Invert(), e.Value.Invert()),
-        Expr.UnaryOperation { Operator: UnaryOperator.Not } uo => uo.Operand,
-        Expr.BinaryOperation bo when bo.Invert() is { HasValue: true } bov => bov.Value,
-        _ => new Expr.UnaryOperation(expr.Meta, new UnaryOperator.Not(expr.Meta), expr, expr.Value.Invert()),
-    };
+    internal static Expr Invert(this Expr expr)
+    {
+        // Parentheses and logical operations are as deep as the source, so their operands are inverted with explicit stacks.
+        Stack<(Expr Expr, bool OperandsInverted)> pending = new();
+        Stack<Expr> inverted = new();
+        pending.Push((expr, false));
+        while (pending.TryPop(out var item)) {
+            switch (item) {
+            case (Expr.ParenExprImpl e, false):
+                pending.Push((e, true));
+                pending.Push((e.ContainedExpression, false));
+                break;
+            case (Expr.BinaryOperation { Operator: BinaryOperator.And or BinaryOperator.Or } bo, false):
+                pending.Push((bo, true));
+                pending.Push((bo.Right, false));
+                pending.Push((bo.Left, false));
+                break;
+            case (Expr.ParenExprImpl e, true):
+                inverted.Push(new Expr.ParenExprImpl(e.Meta, inverted.Pop(), e.Value.Invert()));
+                break;
+            case (Expr.BinaryOperation bo, true): {
+                var right = inverted.Pop();
+                var left = inverted.Pop();
+                inverted.Push(new Expr.BinaryOperation(bo.Meta, left,
+                    bo.Operator is BinaryOperator.And
+                        // NOT (A AND B) <=> NOT A OR NOT B
+                        ? new BinaryOperator.Or(bo.Operator.Meta)
+                        // NOT (A OR B) <=> NOT A AND NOT B
+                        : new BinaryOperator.And(bo.Operator.Meta),
+                    right,
+                    bo.Value.Invert()));
+                break;
+            }
+            default:
+                inverted.Push(item.Expr switch {
+                    Expr.Literal { Value: BooleanValue v } l => new Expr.Literal(l.Meta,
+                        v.Status.ComptimeValue.Match(v => !v, () => l.UnderlyingValue), v.Invert()),
+                    Expr.UnaryOperation { Operator: UnaryOperator.Not } uo => uo.Operand,
+                    Expr.BinaryOperation bo when bo.Invert() is { HasValue: true } bov => bov.Value,
+                    var e => new Expr.UnaryOperation(e.Meta, new UnaryOperator.Not(e.Meta), e, e.Value.Invert()),
+                });
+                break;
+            }
+        }
+        return inverted.Pop();
+    }
 
     static Value Invert(this Value val) => val is BooleanValue b
         ? b.Map(b => !b)
@@ -34,18 +72,6 @@ public static class SemanticNodeExtensions
             BinaryOperator.GreaterThanOrEqual e => bo with { Operator = new BinaryOperator.LessThan(e.Meta), Value = v },
             BinaryOperator.LessThan e => bo with { Operator = new BinaryOperator.GreaterThanOrEqual(e.Meta), Value = v },
             BinaryOperator.LessThanOrEqual e => bo with { Operator = new BinaryOperator.GreaterThan(e.Meta), Value = v },
-            // NOT (A AND B) <=> NOT A OR NOT B
-            BinaryOperator.And e => new Expr.BinaryOperation(bo.Meta,
-                bo.Left.Invert(),
-                new BinaryOperator.Or(e.Meta),
-                bo.Right.Invert(),
-                v),
-            // NOT (A OR B) <=> NOT A AND NOT B
-            BinaryOperator.Or e => new Expr.BinaryOperation(bo.Meta,
-                bo.Left.Invert(),
-                new BinaryOperator.And(e.Meta),
-                bo.Right.Invert(),
-                v),
             // NOT (A XOR B) <=> A = B
             BinaryOperator.Xor e =>
                 (bo with { Operator = new BinaryOperator.Equal(e.Meta), Value = v }).Some(), // gives the target type of the switch expression
@@ -55,7 +81,7 @@ public static class SemanticNodeExtensions
 
     internal static ValueOption<Expr.Literal> ToLiteral<TType, TUnderlying>(this Value<TType, TUnderlying> value, Scope scope)
     where TType : EvaluatedType
-    where TUnderlying : notnull => value.Status is ValueStatus.Comptime<TUnderlying> comptime
+    where TUnderlying : notnull => value.Status.ComptimeValue is { HasValue: true } comptime
         ? new Expr.Literal(new(scope, default), comptime.Value, value).Some()
         : default;
 }
@@ -0,0 +1,123 @@
+using System.Collections.Immutable;
+using System.Runtime.InteropServices;
+
+using Scover.Psdc.Pseudocode;
+using Scover.Psdc.Messages;
+using Scover.Psdc.Parsing;
+
+namespace Scover.Psdc.StaticAnalysis;
+
+public sealed partial class StaticAnalyzer
+{
+    /// <summary>
+    /// The comptime value of an array or a structure being initialized by a braced initializer.
+    /// </summary>
+    /// <remarks>Subobjects are set in place; the value is only rebuilt once, when the initializer is done and the builder is frozen.</remarks>
+    abstract class AggregateBuilder
+    {
+        // A subobject, with its builder once one of its own subobjects has been set.
+        protected record struct Subobject(Value Value, AggregateBuilder? Builder)
+        {
+            public readonly Value Freeze() => Builder?.Freeze() ?? Value;
+        }
+
+        /// <summary>Creates a builder that starts from the value of an aggregate.</summary>
+        /// <returns>A builder, or none if <paramref name="value"/> isn't a comptime array or structure.</returns>
+        static ValueOption<AggregateBuilder> Of(Value value) => value switch {
+            ArrayValue { Status.ComptimeValue.HasValue: true } array => new Array(array).Some<AggregateBuilder>(),
+            StructureValue { Status.ComptimeValue.HasValue: true } structure => new Structure(structure).Some<AggregateBuilder>(),
+            _ => default,
+        };
+
+        /// <summary>Sets the value of the subobject at the end of a path.</summary>
+        /// <param name="location">The location of the initializer item.</param>
+        /// <param name="path">The path to the subobject, relative to this aggregate.</param>
+        /// <param name="value">The value of the subobject.</param>
+        /// <returns>The error that prevented the value from being set, if any.</returns>
+        /// <remarks>Subobjects along the path that aren't comptime are left as they are.</remarks>
+        public ValueOption<Message> SetValue(Range location, InitializerPath path, Value value)
+        {
+            var builder = this;
+            while (true) {
+                var index = builder.IndexOf(location, path.First);
+                if (!index.HasValue) {
+                    return index.Error.Some();
+                }
+                ref var subobject = ref builder.GetSubobject(index.Value);
+                if (path.Rest is not { HasValue: true } rest) {
+                    subobject = new(value, null);
+                    return default;
+                }
+                if (subobject.Builder is null) {
+                    if (Of(subobject.Value) is not { HasValue: true } subobjectBuilder) {
+                        return default;
+                    }
+                    subobject.Builder = subobjectBuilder.Value;
+                }
+                builder = subobject.Builder;
+                path = rest.Value;
+            }
+        }
+
+        /// <summary>Creates the value built so far.</summary>
+        /// <remarks>Aggregates whose subobjects were never set are frozen to their original value.</remarks>
+        public abstract Value Freeze();
+
+        protected abstract ValueOption<int, Message> IndexOf(Range location, DesignatorInfo designator);
+
+        /// <summary>Gets the subobject at an index returned by <see cref="IndexOf"/>, which may then be set.</summary>
+        protected abstract ref Subobject GetSubobject(int index);
+
+        // Only the items that are set are stored, so that large arrays stay sparse.
+        public sealed class Array(ArrayValue original) : AggregateBuilder
+        {
+            readonly SparseArray<Value> _items = original.Status.ComptimeValue.Unwrap();
+            Dictionary<int, Subobject>? _setItems;
+
+            public override Value Freeze() => _setItems is null
+                ? original
+                : original.Type.Instanciate(SparseArray<Value>.Create(_items.Count, _items.DefaultItem,
+                    _items.SetItems.Where(i => !_setItems.ContainsKey(i.Key))
+                       .Concat(_setItems.Select(i => KeyValuePair.Create(i.Key, i.Value.Freeze())))));
+
+            protected override ValueOption<int, Message> IndexOf(Range location, DesignatorInfo designator)
+            {
+                var index = ((DesignatorInfo.Array)designator).Index;
+                return index.Indexes(_items.Count)
+                    ? index
+                    : Message.ErrorIndexOutOfBounds(location, index + 1, _items.Count);
+            }
+
+            protected override ref Subobject GetSubobject(int index)
+            {
+                ref var item = ref CollectionsMarshal.GetValueRefOrAddDefault(_setItems ??= [], index, out bool exists);
+                if (!exists) {
+                    item = new(_items[index], null);
+                }
+                return ref item;
+            }
+        }
+
+        public sealed class Structure(StructureValue original) : AggregateBuilder
+        {
+            readonly ImmutableOrderedMap<Ident, Value> _components = original.Status.ComptimeValue.Unwrap();
+            // In the order of the components of the type, which is the order of the indexes. Null until a component is set.
+            Subobject[]? _subobjects;
+
+            public override Value Freeze() => _subobjects is null
+                ? original
+                : original.Type.Instanciate(new ImmutableOrderedMap<Ident, Value>(original.Type.Components.List
+                   .Zip(_subobjects, (c, s) => KeyValuePair.Create(c.Key, s.Freeze())).ToImmutableList()));
+
+            protected override ValueOption<int, Message> IndexOf(Range location, DesignatorInfo designator)
+            {
+                var component = ((DesignatorInfo.Structure)designator).Component;
+                return original.Type.IndexOfComponent(component)
+                   .OrWithError(Message.ErrorStructureComponentDoesntExist(component, original.Type));
+            }
+
+            protected override ref Subobject GetSubobject(int index) => ref (_subobjects ??= original.Type.Components.List
+               .Select(c => new Subobject(_components.Map[c.Key], null)).ToArray())[index];
+        }
+    }
+}
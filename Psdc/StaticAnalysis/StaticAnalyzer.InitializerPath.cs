@@ -1,5 +1,3 @@
-using System.Collections.Immutable;
-
 using Scover.Psdc.Pseudocode;
 using Scover.Psdc.Messages;
 using Scover.Psdc.Parsing;
@@ -8,8 +6,6 @@ using static Scover.Psdc.StaticAnalysis.SemanticNode;
 
 namespace Scover.Psdc.StaticAnalysis;
 
-using ValueTransform = Func<Value, Option<Value, Message>>;
-
 public sealed partial class StaticAnalyzer
 {
     ValueOption<ValueOption<InitializerPath>, Message> EvaluatePath(Scope scope, ReadOnlySpan<Designator> designators, EvaluatedType targetType) =>
@@ -51,20 +47,20 @@ public sealed partial class StaticAnalyzer
         ValueOption<InitializerPath> Rest { get; }
         EvaluatedType Type { get; }
 
+        /// <summary>Gets the type of the subobject at the end of this path.</summary>
+        EvaluatedType SubobjectType { get; }
+
         /// <summary>Advances this path to the next subobject in natural order.</summary>
         /// <returns>An altered copy of this path.</returns>
         Option<InitializerPath, Message> Advance(Range location);
 
-        Option<Value, Message> SetValue(Range location, object haystack, Value needle);
-
-        abstract record Impl<TSelf, TDesignator, TType, TValue, TUnderlying>(TDesignator First, ValueOption<InitializerPath> Rest, TType Type) : InitializerPath
-        where TSelf : Impl<TSelf, TDesignator, TType, TValue, TUnderlying>
+        abstract record Impl<TSelf, TDesignator, TType>(TDesignator First, ValueOption<InitializerPath> Rest, TType Type) : InitializerPath
+        where TSelf : Impl<TSelf, TDesignator, TType>
         where TDesignator : DesignatorInfo
-        where TType : InstantiableType<TValue, TUnderlying>
-        where TValue : Value
-        where TUnderlying : notnull
+        where TType : EvaluatedType
         {
             EvaluatedType InitializerPath.Type => Type;
+            public EvaluatedType SubobjectType => Rest.Map(r => r.SubobjectType).ValueOr(FirstType);
             DesignatorInfo InitializerPath.First => First;
             public Option<TSelf, Message> Advance(Range location)
             {
@@ -72,25 +68,18 @@ public sealed partial class StaticAnalyzer
                 Option<TSelf, Message> ByFirst() => AdvanceFirst(location).Map(WithFirst);
             }
 
-            public Option<TValue, Message> SetValue(Range location, TUnderlying haystack, Value needle) => SetValueFirst(location, haystack, Rest.Match(
-                    rest => inner => inner.Status.ComptimeValue.Match(
-                        v => rest.SetValue(location, v, needle),
-                        () => inner.Some<Value, Message>()), // If the default value is non-comptime, just leave it as it is.
-                    () => (ValueTransform)(_ => needle.Some<Value, Message>())))
-               .Map(Type.Instanciate);
-
             protected abstract ValueOption<TDesignator, Message> AdvanceFirst(Range location);
-            protected abstract Option<TUnderlying, Message> SetValueFirst(Range location, TUnderlying haystack, ValueTransform transform);
+
+            /// <summary>Gets the type of the subobject designated by <see cref="First"/>.</summary>
+            protected abstract EvaluatedType FirstType { get; }
 
             protected abstract TSelf WithRest(ValueOption<InitializerPath> rest);
             protected abstract TSelf WithFirst(TDesignator first);
 
             Option<InitializerPath, Message> InitializerPath.Advance(Range location) => Advance(location);
-            Option<Value, Message> InitializerPath.SetValue(Range location, object haystack, Value needle) =>
-                SetValue(location, (TUnderlying)haystack, needle).Map(v => (Value)v);
         }
         sealed record Array(DesignatorInfo.Array First, ValueOption<InitializerPath> Rest, ArrayType Type)
-            : Impl<Array, DesignatorInfo.Array, ArrayType, ArrayValue, ImmutableArray<Value>>(First, Rest, Type)
+            : Impl<Array, DesignatorInfo.Array, ArrayType>(First, Rest, Type)
         {
             public static ValueOption<Array, Message> OfFirstObject(ArrayType type, Range location) => 0.Indexes(type.Length.Value)
                 ? new Array(new(0), default, type)
@@ -98,37 +87,24 @@ public sealed partial class StaticAnalyzer
             protected override ValueOption<DesignatorInfo.Array, Message> AdvanceFirst(Range location) => (First.Index + 1).Indexes(Type.Length.Value)
                 ? new DesignatorInfo.Array(First.Index + 1)
                 : Message.ErrorIndexOutOfBounds(location, First.Index + 2, Type.Length.Value);
-            protected override Option<ImmutableArray<Value>, Message> SetValueFirst(Range location, ImmutableArray<Value> haystack, ValueTransform transform) =>
-                haystack.ElementAtOrNone(First.Index)
-                   .OrWithError(Message.ErrorIndexOutOfBounds(location, First.Index + 1, haystack.Length))
-                   .Bind(transform)
-                   .Map(inner => haystack.SetItem(First.Index, inner));
+            protected override EvaluatedType FirstType => Type.ItemType;
             protected override Array WithFirst(DesignatorInfo.Array first) => this with { First = first };
             protected override Array WithRest(ValueOption<InitializerPath> rest) => this with { Rest = rest };
         }
         sealed record Structure(DesignatorInfo.Structure First, ValueOption<InitializerPath> Rest, StructureType Type)
-            : Impl<Structure, DesignatorInfo.Structure, StructureType, StructureValue, ImmutableOrderedMap<Ident, Value>>(First, Rest, Type)
+            : Impl<Structure, DesignatorInfo.Structure, StructureType>(First, Rest, Type)
         {
             public static ValueOption<Structure, Message> OfFirstObject(StructureType type, Range location) => type.Components.List.FirstOrNone()
                .Map(comp => new Structure(new(comp.Key), default, type))
                .OrWithError(Message.ErrorExcessElementInInitializer(location));
 
             protected override ValueOption<DesignatorInfo.Structure, Message> AdvanceFirst(Range location) => Type.Components.List.TryGetAt(1
-              + Type.Components.List
-                   .IndexOfFirst(i => i.Key.Equals(First.Component)).Unwrap(),
+              + Type.IndexOfComponent(First.Component).Unwrap(),
                 out var c)
                 ? new DesignatorInfo.Structure(c.Key)
                 : Message.ErrorExcessElementInInitializer(location);
 
-            protected override Option<ImmutableOrderedMap<Ident, Value>, Message> SetValueFirst(
-                Range location,
-                ImmutableOrderedMap<Ident, Value> haystack,
-                ValueTransform transform
-            ) => haystack.Map.GetValueOrNone(First.Component)
-               .OrWithError(Message.ErrorStructureComponentDoesntExist(First.Component, Type))
-               .Bind(transform)
-               .Map(inner => haystack.SetItem(First.Component, inner));
-
+            protected override EvaluatedType FirstType => Type.Components.Map[First.Component];
             protected override Structure WithFirst(DesignatorInfo.Structure first) => this with { First = first };
             protected override Structure WithRest(ValueOption<InitializerPath> rest) => this with { Rest = rest };
         }
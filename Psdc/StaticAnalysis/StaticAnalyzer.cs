@@ -1,3 +1,4 @@
+using Scover.Psdc.Lexing;
 using Scover.Psdc.Pseudocode;
 using Scover.Psdc.Messages;
 
@@ -20,11 +21,16 @@ public sealed partial class StaticAnalyzer
     }
     readonly Messenger _msger;
     readonly string _input;
+    readonly TypeInterner _types;
 
     MainProgramStatus _mainProgramStatus;
     ValueOption<Symbol.Callable> _currentCallable;
 
-    StaticAnalyzer(Messenger messenger, string input) => (_msger, _input) = (messenger, input);
+    // The expressions being evaluated, shared by nested evaluations, each above the previous ones, so that evaluating an expression doesn't allocate stacks.
+    readonly Stack<(Node.Expr Expr, bool OperandsEvaluated)> _pendingExprs = new();
+    readonly Stack<Expr> _evaluatedExprs = new();
+
+    StaticAnalyzer(Messenger messenger, string input) => (_msger, _input, _types) = (messenger, input, new(input));
 
     void EvaluateCompilerDirective(Scope scope, Node.CompilerDirective compilerDirective)
     {
@@ -54,11 +60,11 @@ public sealed partial class StaticAnalyzer
         }
     }
 
-    public static Algorithm Analyze(Messenger messenger, string input, Node.Algorithm ast)
+    public static Algorithm Analyze(Messenger messenger, string input, NameTable names, Node.Algorithm ast)
     {
         StaticAnalyzer a = new(messenger, input);
 
-        MutableScope scope = new(null);
+        MutableScope scope = new(names);
 
         foreach (var directive in ast.LeadingDirectives) {
             a.EvaluateCompilerDirective(scope, directive);
@@ -89,18 +95,20 @@ public sealed partial class StaticAnalyzer
                 _msger.Report(Message.HintUnofficialFeatureScalarInitializers(constant.Value.Location));
             }
 
-            if (init.Value.Status is not ValueStatus.Comptime) {
+            if (init.Value.Status.Kind is not ValueStatusKind.Comptime) {
                 _msger.Report(Message.ErrorComptimeExpressionExpected(constant.Value.Location));
             }
 
-            scope.AddOrError(_msger, new Symbol.Constant(constant.Name, constant.Location, type, init.Value));
+            Symbol.Constant symbol = new(constant.Name, constant.Location, type, init.Value);
+            scope.AddOrError(_msger, symbol);
 
-            return new Declaration.Constant(meta, type, constant.Name, init);
+            return new Declaration.Constant(meta, type, symbol, init);
         }
         case Node.Declaration.Function d: {
             var sig = AnalyzeSignature(scope, d.Signature);
-            AddCallableDeclarationSymbol(scope, MakeSymbol(sig, DeclareParameter));
-            return new Declaration.Callable(meta, sig);
+            var f = MakeSymbol(sig, DeclareParameter);
+            AddCallableDeclarationSymbol(scope, f);
+            return new Declaration.Callable(meta, f, sig);
         }
         case Node.Declaration.FunctionDefinition d: {
             MutableScope funcScope = new(scope);
@@ -110,7 +118,7 @@ public sealed partial class StaticAnalyzer
             AddCallableDefinitionSymbol(scope, f);
 
             _currentCallable = f;
-            var sFuncDef = new Declaration.CallableDefinition(meta, sig, AnalyzeStatements(funcScope, d.Body));
+            var sFuncDef = new Declaration.CallableDefinition(meta, f, sig, AnalyzeStatements(funcScope, d.Body));
             _currentCallable = default;
 
             return sFuncDef;
@@ -126,8 +134,9 @@ public sealed partial class StaticAnalyzer
         }
         case Node.Declaration.Procedure d: {
             var sig = AnalyzeSignature(scope, d.Signature);
-            AddCallableDeclarationSymbol(scope, MakeSymbol(sig, DeclareParameter));
-            return new Declaration.Callable(meta, sig);
+            var p = MakeSymbol(sig, DeclareParameter);
+            AddCallableDeclarationSymbol(scope, p);
+            return new Declaration.Callable(meta, p, sig);
         }
         case Node.Declaration.ProcedureDefinition d: {
             MutableScope procScope = new(scope);
@@ -135,14 +144,15 @@ public sealed partial class StaticAnalyzer
             var p = MakeSymbol(sig, DefineParameter(inScope: procScope));
             AddCallableDefinitionSymbol(scope, p);
             _currentCallable = p;
-            Declaration.CallableDefinition sProcDef = new(meta, sig, AnalyzeStatements(procScope, d.Body));
+            Declaration.CallableDefinition sProcDef = new(meta, p, sig, AnalyzeStatements(procScope, d.Body));
             _currentCallable = default;
             return sProcDef;
         }
         case Node.Declaration.TypeAlias d: {
             var type = EvaluateType(scope, d.Type);
-            scope.AddOrError(_msger, new Symbol.TypeAlias(d.Name, d.Location, type));
-            return new Declaration.TypeAlias(meta, d.Name, type);
+            Symbol.TypeAlias symbol = new(d.Name, d.Location, type);
+            scope.AddOrError(_msger, symbol);
+            return new Declaration.TypeAlias(meta, symbol, type);
         }
         case Node.CompilerDirective cd: {
             EvaluateCompilerDirective(scope, cd);
@@ -304,9 +314,6 @@ public sealed partial class StaticAnalyzer
         }
         case Node.Stmt.LocalVariable s: {
             var type = EvaluateType(scope, s.Decl.Type);
-            var declaration = new VariableDeclaration(new(scope, s.Decl.Location),
-                s.Decl.Names,
-                type);
             var initializer = s.Value.Map(i => {
                 var init = AnalyzeInitializer(scope, i, EvaluatedType.IsAssignableTo, type);
                 if (init is Expr) {
@@ -315,11 +322,12 @@ public sealed partial class StaticAnalyzer
                 return init;
             });
 
-            foreach (var name in declaration.Names) {
-                scope.AddOrError(_msger, new Symbol.LocalVariable(name, s.Location, type, initializer.Map(i => i.Value)));
+            var variables = s.Decl.Names.Select(name => new Symbol.LocalVariable(name, s.Location, type, initializer.Map(i => i.Value))).ToArray();
+            foreach (var variable in variables) {
+                scope.AddOrError(_msger, variable);
             }
 
-            return new Statement.LocalVariable(meta, declaration, initializer);
+            return new Statement.LocalVariable(meta, new(new(scope, s.Decl.Location), variables, type), initializer);
         }
         case Node.Stmt.RepeatLoop s: {
             return new Statement.RepeatLoop(meta,
@@ -357,7 +365,7 @@ public sealed partial class StaticAnalyzer
                         switch (@case) {
                         case Node.Stmt.Switch.Case.OfValue c: {
                             var caseExpr = EvaluateExpression(scope, c.Value, EvaluatedType.IsConvertibleTo, expr.Value.Type);
-                            if (caseExpr.Value.Status is not ValueStatus.Comptime) {
+                            if (caseExpr.Value.Status.Kind is not ValueStatusKind.Comptime) {
                                 _msger.Report(Message.ErrorComptimeExpressionExpected(c.Value.Location));
                             }
                             return new Statement.Switch.Case.OfValue(new(scope, c.Location), caseExpr, AnalyzeStatements(scope, c.Body));
@@ -404,8 +412,7 @@ public sealed partial class StaticAnalyzer
                 switch (targetType) {
                 case ArrayType targetArrayType: {
                     // Deeply initializes each subobject to its default value.
-                    var arrayValue = targetArrayType
-                       .DefaultValue; // todo: let this be a comptime value abstraction (couple bewteen type and comptime value that is implicitly convertible to Value)
+                    var arrayValue = new AggregateBuilder.Array(targetArrayType.DefaultValue);
 
                     var currentPath = Option.None<InitializerPath.Array>();
 
@@ -424,19 +431,14 @@ public sealed partial class StaticAnalyzer
                                    .DropError(_msger.Report);
                             }
 
-                            return currentPath.Map(p => p.Type.ItemType);
-                        }, sitem => currentPath.Bind(p => p.SetValue(
-                                    sitem.Meta.Location,
-                                    arrayValue.Status.ComptimeValue.Unwrap(),
-                                    sitem.Value.Value)
-                               .DropError(_msger.Report))
-                           .Tap(v => arrayValue = v)
+                            return currentPath.Map(p => p.SubobjectType);
+                        }, sitem => currentPath.Tap(p => arrayValue.SetValue(sitem.Meta.Location, p, sitem.Value.Value).Tap(_msger.Report))
                     ).ToArray();
 
-                    return (arrayValue, sitems);
+                    return (arrayValue.Freeze(), sitems);
                 }
                 case StructureType targetStructType: {
-                    var structValue = targetStructType.DefaultValue;
+                    var structValue = new AggregateBuilder.Structure(targetStructType.DefaultValue);
 
                     var currentPath = Option.None<InitializerPath.Structure>();
 
@@ -455,13 +457,11 @@ public sealed partial class StaticAnalyzer
                                    .DropError(_msger.Report);
                             }
 
-                            return currentPath.Map(p => p.Type.Components.Map[p.First.Component]);
-                        }, sitem => currentPath.Bind(p => p.SetValue(sitem.Meta.Location, structValue.Status.ComptimeValue.Unwrap(), sitem.Value.Value)
-                               .DropError(_msger.Report))
-                           .Tap(v => structValue = v))
+                            return currentPath.Map(p => p.SubobjectType);
+                        }, sitem => currentPath.Tap(p => structValue.SetValue(sitem.Meta.Location, p, sitem.Value.Value).Tap(_msger.Report)))
                        .ToArray();
 
-                    return (structValue, sitems);
+                    return (structValue.Freeze(), sitems);
                 }
                 default: {
                     _msger.Report(Message.ErrorUnsupportedInitializer(initializer.Location, targetType));
@@ -524,162 +524,214 @@ public sealed partial class StaticAnalyzer
     Expr EvaluateExpression(Scope scope, Node.Expr expr, Func<Value, Value>? adjustValue = null)
     {
         adjustValue ??= v => v;
-        SemanticMetadata meta = new(scope, expr.Location);
-        switch (expr) {
-        case Node.Expr.Literal lit: {
-            var value = lit.CreateValue();
-            return new Expr.Literal(meta, lit.Value, adjustValue(value));
-        }
-        case Node.Expr.ParenExprImpl b: {
-            var contained = EvaluateExpression(scope, b.InnerExpr);
-            return new Expr.ParenExprImpl(meta, contained, adjustValue(contained.Value));
-        }
-        case Node.Expr.BinaryOperation opBin: {
-            var left = EvaluateExpression(scope, opBin.Left);
-            var right = EvaluateExpression(scope, opBin.Right);
+        // Parentheses, operations and accesses are as deep as the source: evaluate their operands with explicit stacks, in the order of the source, except for indexes which are evaluated from the outermost access.
+        var pending = _pendingExprs;
+        var evaluated = _evaluatedExprs;
+        int start = pending.Count;
+        pending.Push((expr, false));
+        while (pending.Count != start) {
+            var (node, operandsEvaluated) = pending.Pop();
+            // Only the value of the whole expression is adjusted.
+            Func<Value, Value> adjust = pending.Count == start ? adjustValue : static v => v;
+            SemanticMetadata meta = new(scope, node.Location);
+
+            if (!operandsEvaluated) {
+                switch (node) {
+                case Node.Expr.ParenExprImpl b:
+                    pending.Push((b, true));
+                    pending.Push((b.InnerExpr, false));
+                    continue;
+                case Node.Expr.Lvalue.ParenLValue b:
+                    pending.Push((b, true));
+                    pending.Push((b.ContainedLvalue, false));
+                    continue;
+                case Node.Expr.BinaryOperation opBin:
+                    pending.Push((opBin, true));
+                    pending.Push((opBin.Right, false));
+                    pending.Push((opBin.Left, false));
+                    continue;
+                case Node.Expr.UnaryOperation opUn:
+                    pending.Push((opUn, true));
+                    pending.Push((opUn.Operand, false));
+                    continue;
+                case Node.Expr.Lvalue.ArraySubscript arrSub:
+                    pending.Push((arrSub, true));
+                    pending.Push((arrSub.Array, false));
+                    pending.Push((arrSub.Index, false));
+                    continue;
+                case Node.Expr.Lvalue.ComponentAccess compAccess:
+                    pending.Push((compAccess, true));
+                    pending.Push((compAccess.Structure, false));
+                    continue;
+                }
+            }
 
-            var result = opBin.Operator.EvaluateOperation(left.Value, right.Value);
-            foreach (var msg in result.Messages) {
-                _msger.Report(msg(opBin, left.Value.Type, right.Value.Type));
+            switch (node) {
+            case Node.Expr.Literal lit: {
+                var value = lit.CreateValue();
+                evaluated.Push(new Expr.Literal(meta, lit.Value, adjust(value)));
+                break;
+            }
+            case Node.Expr.ParenExprImpl: {
+                var contained = evaluated.Pop();
+                evaluated.Push(new Expr.ParenExprImpl(meta, contained, adjust(contained.Value)));
+                break;
             }
+            case Node.Expr.BinaryOperation opBin: {
+                var right = evaluated.Pop();
+                var left = evaluated.Pop();
 
-            return new Expr.BinaryOperation(meta, left, AnalyzeOperator(scope, opBin.Operator), right, adjustValue(result.Value));
-        }
-        case Node.Expr.UnaryOperation opUn: {
-            var operand = EvaluateExpression(scope, opUn.Operand);
+                var result = opBin.Operator.EvaluateOperation(left.Value, right.Value);
+                foreach (var msg in result.Messages) {
+                    _msger.Report(msg(opBin, left.Value.Type, right.Value.Type));
+                }
 
-            var result = this.EvaluateOperation(scope, opUn.Operator, operand.Value);
-            foreach (var msg in result.Messages) {
-                _msger.Report(msg(opUn, operand.Value.Type));
+                evaluated.Push(new Expr.BinaryOperation(meta, left, AnalyzeOperator(scope, opBin.Operator), right, adjust(result.Value)));
+                break;
             }
+            case Node.Expr.UnaryOperation opUn: {
+                var operand = evaluated.Pop();
+
+                var result = this.EvaluateOperation(scope, opUn.Operator, operand.Value);
+                foreach (var msg in result.Messages) {
+                    _msger.Report(msg(opUn, operand.Value.Type));
+                }
 
-            return new Expr.UnaryOperation(meta, AnalyzeOperator(scope, opUn.Operator), operand, adjustValue(result.Value));
+                evaluated.Push(new Expr.UnaryOperation(meta, AnalyzeOperator(scope, opUn.Operator), operand, adjust(result.Value)));
+                break;
+            }
+            case Node.Expr.Call call: {
+                evaluated.Push(EvaluateCall(scope, meta, call, adjust));
+                break;
+            }
+            case Node.Expr.BuiltinFdf fdf: {
+                evaluated.Push(new Expr.BuiltinFdf(meta,
+                    EvaluateExpression(scope, fdf.ArgumentNomLog, EvaluatedType.IsConvertibleTo, FileType.Instance),
+                    adjust(BooleanType.Instance.RuntimeValue)));
+                break;
+            }
+            case Node.Expr.Lvalue.ParenLValue: {
+                var contained = (Expr.Lvalue)evaluated.Pop();
+                evaluated.Push(new Expr.Lvalue.ParenLValue(meta, contained, adjust(contained.Value)));
+                break;
+            }
+            case Node.Expr.Lvalue.ArraySubscript arrSub: {
+                var array = evaluated.Pop();
+                var index = evaluated.Pop();
+                evaluated.Push(new Expr.Lvalue.ArraySubscript(meta, array, index, adjust(EvaluateArraySubscript(arrSub, array, index))));
+                break;
+            }
+            case Node.Expr.Lvalue.ComponentAccess compAccess: {
+                var structure = evaluated.Pop();
+                evaluated.Push(new Expr.Lvalue.ComponentAccess(meta, structure, compAccess.ComponentName, adjust(EvaluateComponentAccess(compAccess, structure))));
+                break;
+            }
+            case Node.Expr.Lvalue.VariableReference varRef: {
+                // Looking the symbol up as an option allocates, so only do it to report the error.
+                var variable = scope.TryGetSymbol(varRef.Name, out Symbol.Variable? found)
+                    ? found.Some()
+                    : scope.GetSymbol<Symbol.Variable>(varRef.Name).DropError(_msger.Report);
+                evaluated.Push(new Expr.Lvalue.VariableReference(meta, varRef.Name, variable,
+                    adjust(variable
+                       .Map(vp => vp is Symbol.Constant constant
+                            ? constant.Value
+                            : vp.Type.RuntimeValue)
+                       .ValueOr(UnknownType.Inferred.InvalidValue))));
+                break;
+            }
+            default: throw node.ToUnmatchedException();
+            }
         }
-        case Node.Expr.Call call: {
-            var parameters = AnalyzeParameters(scope, call.Parameters);
+        return evaluated.Pop();
+    }
 
-            var callable = scope.GetSymbol<Symbol.Callable>(call.Callee).DropError(_msger.Report).Tap(callable => {
-                List<string> problems = [];
+    // Separate from EvaluateExpression so that its closures aren't allocated for every expression.
+    Expr.Call EvaluateCall(Scope scope, SemanticMetadata meta, Node.Expr.Call call, Func<Value, Value> adjustValue)
+    {
+        var parameters = AnalyzeParameters(scope, call.Parameters);
 
-                if (call.Parameters.Count != callable.Parameters.Count) {
-                    problems.Add(Message.ProblemWrongNumberOfArguments(
-                        callable.Parameters.Count, call.Parameters.Count));
-                }
+        var callable = scope.GetSymbol<Symbol.Callable>(call.Callee).DropError(_msger.Report).Tap(callable => {
+            List<string> problems = [];
 
-                foreach (var (actual, formal) in parameters.Zip(callable.Parameters)) {
-                    if (actual.Mode != formal.Mode) {
-                        problems.Add(Message.ProblemWrongArgumentMode(formal.Name,
-                            formal.Mode.RepresentationActual, actual.Mode.RepresentationActual));
-                    }
+            if (call.Parameters.Count != callable.Parameters.Count) {
+                problems.Add(Message.ProblemWrongNumberOfArguments(
+                    callable.Parameters.Count, call.Parameters.Count));
+            }
 
-                    var actualType = actual.Value.Value.Type;
-                    if (!actualType.IsConvertibleTo(formal.Type)) {
-                        problems.Add(Message.ProblemWrongArgumentType(formal.Name, formal.Type, actualType));
-                    }
+            foreach (var (actual, formal) in parameters.Zip(callable.Parameters)) {
+                if (actual.Mode != formal.Mode) {
+                    problems.Add(Message.ProblemWrongArgumentMode(formal.Name,
+                        formal.Mode.RepresentationActual, actual.Mode.RepresentationActual));
                 }
 
-                if (problems.Count > 0) {
-                    _msger.Report(Message.ErrorCallParameterMismatch(call.Location, callable, problems));
+                var actualType = actual.Value.Value.Type;
+                if (!actualType.IsConvertibleTo(formal.Type)) {
+                    problems.Add(Message.ProblemWrongArgumentType(formal.Name, formal.Type, actualType));
                 }
-            }, none: () => {
-                // If the callable symbol wasn't found, still analyze the parameter expressions.
-                foreach (var actual in call.Parameters) {
-                    EvaluateExpression(scope, actual.Value);
-                }
-            });
+            }
 
-            return new Expr.Call(meta, call.Callee, parameters,
-                adjustValue(callable
-                   .Map(f => f.ReturnType)
-                   .ValueOr(UnknownType.Inferred)
-                   .RuntimeValue));
-        }
-        case Node.Expr.BuiltinFdf fdf: {
-            return new Expr.BuiltinFdf(meta,
-                EvaluateExpression(scope, fdf.ArgumentNomLog, EvaluatedType.IsConvertibleTo, FileType.Instance),
-                adjustValue(BooleanType.Instance.RuntimeValue));
-        }
-        case Node.Expr.Lvalue lvalue: {
-            return EvaluateLvalue(scope, lvalue, adjustValue);
-        }
-        default: throw expr.ToUnmatchedException();
-        }
+            if (problems.Count > 0) {
+                _msger.Report(Message.ErrorCallParameterMismatch(call.Location, callable, problems));
+            }
+        }, none: () => {
+            // If the callable symbol wasn't found, still analyze the parameter expressions.
+            foreach (var actual in call.Parameters) {
+                EvaluateExpression(scope, actual.Value);
+            }
+        });
+
+        return new Expr.Call(meta, call.Callee, callable, parameters,
+            adjustValue(callable
+               .Map(f => f.ReturnType)
+               .ValueOr(UnknownType.Inferred)
+               .RuntimeValue));
     }
 
     Expr.Lvalue EvaluateLvalue(Scope scope, Node.Expr.Lvalue expr, TypeComparer typeComparer, EvaluatedType targetType) =>
         EvaluateLvalue(scope, expr, v => CheckType(expr.Location, typeComparer, targetType, v));
 
-    Expr.Lvalue EvaluateLvalue(Scope scope, Node.Expr.Lvalue lvalue, Func<Value, Value>? adjustValue = null)
-    {
-        adjustValue ??= v => v;
-        SemanticMetadata meta = new(scope, lvalue.Location);
-        switch (lvalue) {
-        case Node.Expr.Lvalue.ArraySubscript arrSub: {
-            var index = EvaluateExpression(scope, arrSub.Index);
+    Expr.Lvalue EvaluateLvalue(Scope scope, Node.Expr.Lvalue lvalue, Func<Value, Value>? adjustValue = null) =>
+        (Expr.Lvalue)EvaluateExpression(scope, lvalue, adjustValue);
 
-            var array = EvaluateExpression(scope, arrSub.Array);
-            return new Expr.Lvalue.ArraySubscript(meta, array, index, adjustValue(Evaluate()));
-
-            Value Evaluate()
-            {
-                if (array.Value is ArrayValue arrVal) {
-                    ValueOption<int> actualIndex;
-
-                    if (index.Value is IntegerValue intVal) {
-                        actualIndex = intVal.Status.ComptimeValue;
-                    } else {
-                        _msger.Report(Message.ErrorNonIntegerIndex(index.Meta.Location, index.Value.Type));
-                        return arrVal.Type.ItemType.InvalidValue;
-                    }
+    Value EvaluateArraySubscript(Node.Expr.Lvalue.ArraySubscript arrSub, Expr array, Expr index)
+    {
+        if (array.Value is ArrayValue arrVal) {
+            ValueOption<int> actualIndex;
 
-                    var length = arrVal.Type.Length.Value;
+            if (index.Value is IntegerValue intVal) {
+                actualIndex = intVal.Status.ComptimeValue;
+            } else {
+                _msger.Report(Message.ErrorNonIntegerIndex(index.Meta.Location, index.Value.Type));
+                return arrVal.Type.ItemType.InvalidValue;
+            }
 
-                    if (actualIndex is { HasValue: true } i && !i.Value.Indexes(length, 1)) {
-                        _msger.Report(Message.ErrorIndexOutOfBounds(arrSub.Location, i.Value, length));
-                        return arrVal.Type.ItemType.InvalidValue;
-                    }
+            var length = arrVal.Type.Length.Value;
 
-                    return arrVal.Status.ComptimeValue.Zip(actualIndex)
-                       .Map((arr, index) => arr[index - 1])
-                       .ValueOr(arrVal.Type.ItemType.RuntimeValue);
-                }
-                _msger.Report(Message.ErrorSubscriptOfNonArray(arrSub.Location, array.Value.Type));
-                return UnknownType.Inferred.InvalidValue;
+            if (actualIndex is { HasValue: true } i && !i.Value.Indexes(length, 1)) {
+                _msger.Report(Message.ErrorIndexOutOfBounds(arrSub.Location, i.Value, length));
+                return arrVal.Type.ItemType.InvalidValue;
             }
-        }
-        case Node.Expr.Lvalue.ParenLValue b: {
-            var contained = EvaluateLvalue(scope, b.ContainedLvalue);
-            return new Expr.Lvalue.ParenLValue(meta, contained, adjustValue(contained.Value));
-        }
-        case Node.Expr.Lvalue.ComponentAccess compAccess: {
-            var @struct = EvaluateExpression(scope, compAccess.Structure);
-            return new Expr.Lvalue.ComponentAccess(meta, @struct, compAccess.ComponentName, adjustValue(Evaluate()));
 
-            Value Evaluate()
-            {
-                if (@struct.Value is not StructureValue structVal) {
-                    _msger.Report(Message.ErrrorComponentAccessOfNonStruct(compAccess, @struct.Value.Type));
-                } else if (!structVal.Type.Components.Map.TryGetValue(compAccess.ComponentName, out var componentType)) {
-                    _msger.Report(Message.ErrorStructureComponentDoesntExist(compAccess.ComponentName, structVal.Type));
-                } else {
-                    return structVal.Status.ComptimeValue
-                       .Map(s => s.Map[compAccess.ComponentName])
-                       .ValueOr(componentType.RuntimeValue);
-                }
-                return UnknownType.Inferred.InvalidValue;
-            }
-        }
-        case Node.Expr.Lvalue.VariableReference varRef: {
-            return new Expr.Lvalue.VariableReference(meta, varRef.Name,
-                adjustValue(scope.GetSymbol<Symbol.Variable>(varRef.Name)
-                   .DropError(_msger.Report)
-                   .Map(vp => vp is Symbol.Constant constant
-                        ? constant.Value
-                        : vp.Type.RuntimeValue)
-                   .ValueOr(UnknownType.Inferred.InvalidValue)));
+            return arrVal.Status.ComptimeValue.Zip(actualIndex)
+               .Map((arr, index) => arr[index - 1])
+               .ValueOr(arrVal.Type.ItemType.RuntimeValue);
         }
-        default: throw lvalue.ToUnmatchedException();
+        _msger.Report(Message.ErrorSubscriptOfNonArray(arrSub.Location, array.Value.Type));
+        return UnknownType.Inferred.InvalidValue;
+    }
+
+    Value EvaluateComponentAccess(Node.Expr.Lvalue.ComponentAccess compAccess, Expr @struct)
+    {
+        if (@struct.Value is not StructureValue structVal) {
+            _msger.Report(Message.ErrrorComponentAccessOfNonStruct(compAccess, @struct.Value.Type));
+        } else if (!structVal.Type.Components.Map.TryGetValue(compAccess.ComponentName, out var componentType)) {
+            _msger.Report(Message.ErrorStructureComponentDoesntExist(compAccess.ComponentName, structVal.Type));
+        } else {
+            return structVal.Status.ComptimeValue
+               .Map(s => s.Map[compAccess.ComponentName])
+               .ValueOr(componentType.RuntimeValue);
         }
+        return UnknownType.Inferred.InvalidValue;
     }
 
     static BinaryOperator AnalyzeOperator(Scope scope, Node.BinaryOperator binOp)
@@ -739,7 +791,7 @@ public sealed partial class StaticAnalyzer
     internal EvaluatedType EvaluateType(Scope scope, Node.Type type) => type switch {
         Node.Type.AliasReference alias
             => scope.GetSymbol<Symbol.TypeAlias>(alias.Name).DropError(_msger.Report)
-               .Map(aliasType => aliasType.Type.ToAliasReference(alias.Name))
+               .Map(aliasType => _types.AliasReference(aliasType.Type, alias.Name))
                .ValueOr(UnknownType.Declared(_input, type.Location)),
         Node.Type.Array array => EvaluateArrayType(scope, array),
         Node.Type.Boolean => BooleanType.Instance,
@@ -756,7 +808,7 @@ public sealed partial class StaticAnalyzer
     EvaluatedType EvaluateLengthedStringType(Scope scope, Node.Type.LengthedString str) =>
         GetComptimeExpression<IntegerType, int>(IntegerType.Instance, scope, str.Length)
            .DropError(_msger.Report)
-           .Map(LengthedStringType.Create)
+           .Map(_types.LengthedString)
            .ValueOr<EvaluatedType>(UnknownType.Declared(_input, str.Location));
 
     EvaluatedType EvaluateArrayType(Scope scope, Node.Type.Array array) => array.Dimensions
@@ -766,7 +818,7 @@ public sealed partial class StaticAnalyzer
             var type = EvaluateType(scope, array.Type);
             Debug.Assert(dimensions.Any());
             // Start innermost with the least significant dimension
-            return dimensions.Reverse().Aggregate(type, (current, dim) => new ArrayType(current, dim));
+            return dimensions.Reverse().Aggregate(type, (current, dim) => _types.Array(current, dim));
         })
        .ValueOr(UnknownType.Declared(_input, array.Location));
 
@@ -792,8 +844,8 @@ public sealed partial class StaticAnalyzer
         foreach (var c in structure.Components) {
             switch (c) {
             case Node.VariableDeclaration comp: {
+                var type = EvaluateType(scope, comp.Type);
                 foreach (var name in comp.Names) {
-                    var type = EvaluateType(scope, comp.Type);
                     if (!components.TryAdd(name, type, out components)) {
                         _msger.Report(Message.ErrorStructureDuplicateComponent(comp.Location, name));
                     }
@@ -807,7 +859,7 @@ public sealed partial class StaticAnalyzer
             default: throw c.ToUnmatchedException();
             }
         }
-        return new StructureType(components);
+        return _types.Structure(components);
     }
 
     delegate bool TypeComparer(EvaluatedType actual, EvaluatedType expected);